@@ -0,0 +1,87 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "async_logger.h"
+
+/*
+printNumbers() in mutex.cpp locks a mutex just to write a line to std::cout, so every thread that wants to print
+waits for every other thread's formatting and terminal I/O. logging::AsyncLogger from async_logger.h takes both off
+the calling thread: log() only copies its arguments into a per-thread ring buffer, and a background thread formats
+them and writes everything it found with one writev().
+The benchmark has N threads log the same message with both approaches, writing to /dev/null so the numbers measure
+the logging path and not the terminal.
+*/
+
+// -std=c++11 -O2 -pthread, POSIX
+
+using Clock = std::chrono::steady_clock;
+
+std::mutex mtx;
+
+// mutex.cpp's printNumbers, the lock_guard + std::cout pattern
+void printNumbers(std::ostream& out, int id, int count) {
+    for (int i = 0; i < count; ++i) {
+        std::lock_guard<std::mutex> lock(mtx);
+        out << "Thread " << id << " prints: " << i << " value " << i * 0.5 << "\n";
+    }
+}
+
+void logNumbers(logging::AsyncLogger& logger, int id, int count) {
+    for (int i = 0; i < count; ++i) {
+        logger.log("Thread %d prints: %d value %g\n", id, i, i * 0.5);
+    }
+}
+
+// Returns {million messages/s seen by the logging threads, million messages/s until everything was written}
+template <class Body, class Finish>
+std::pair<double, double> measure(int threads, int perThread, Body body, Finish finish) {
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(body, t);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> logged = Clock::now() - start;
+    finish();
+    std::chrono::duration<double> written = Clock::now() - start;
+    double total = static_cast<double>(threads) * perThread;
+    return std::make_pair(total / logged.count() / 1e6, total / written.count() / 1e6);
+}
+
+int main() {
+    // Example 1: mutex.cpp's output through the logger - no lock in the printing threads
+    {
+        logging::AsyncLogger logger;  // stdout
+        std::thread t1(logNumbers, std::ref(logger), 1, 5);
+        std::thread t2(logNumbers, std::ref(logger), 2, 5);
+        t1.join();
+        t2.join();
+    }  // The destructor writes whatever is still buffered
+
+    // Example 2: Messages per second against lock_guard + std::ostream
+    const int perThread = 100000;
+    int devNull = open("/dev/null", O_WRONLY);
+    std::ofstream nullStream("/dev/null");
+    std::printf("\nthreads   mutex+ostream M/s   logger M/s (returned)   logger M/s (written)\n");
+    for (int threads : {1, 2, 4, 8}) {
+        auto locked = measure(threads, perThread, [&](int id) { printNumbers(nullStream, id, perThread); },
+                              [&] { nullStream.flush(); });
+        logging::AsyncLogger logger(devNull, 8 << 20);  // Room for a whole run: "returned" is the cost of log() itself
+        auto async = measure(threads, perThread, [&](int id) { logNumbers(logger, id, perThread); },
+                             [&] { logger.flush(); });
+        std::printf("%7d %19.2f %23.2f %22.2f\n", threads, locked.second, async.first, async.second);
+    }
+    close(devNull);
+
+    return 0;
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/*
+AsyncLogger: logging that does not make threads wait for each other or for the terminal.
+- Producer side: logger.log("x = %d\n", x) does not format anything. It copies the format string pointer, the
+  arguments and a timestamp into a per-thread ring buffer and returns - no lock, no system call, no shared cache
+  line except the ring's own indices.
+- A background thread walks the rings, does the printf-style formatting, and writes the text of every thread with
+  a single writev() per sweep.
+- Each thread's messages come out in the order it logged them; messages of different threads are interleaved per
+  sweep, not sorted by timestamp.
+- Arguments are stored as raw bytes, so they must be trivially copyable: numbers, pointers, and const char* that
+  stay valid until the message is written (string literals). Format strings must be literals too.
+- When a thread's ring is full, log() yields until the background thread has made room, so nothing is lost. A
+  record that could never fit (larger than half the ring, see ThreadBuffer::fits) is rejected with
+  std::length_error instead.
+- A thread gets one ring per logger it uses, so alternating between loggers costs nothing extra.
+flush() waits until everything logged before the call has been written; the destructor flushes and stops.
+*/
+
+// -std=c++11 -pthread, POSIX (writev)
+
+namespace logging {
+
+namespace detail {
+
+template <std::size_t... I>
+struct Indices {};
+template <std::size_t N, std::size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <std::size_t... I>
+struct MakeIndices<0, I...> {
+    typedef Indices<I...> type;
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+template <class... Args>
+void appendFormatted(std::string& out, const char* format, Args... args) {
+    char stack[256];
+    int n = std::snprintf(stack, sizeof(stack), format, args...);
+    if (n < 0) {
+        return;
+    }
+    if (static_cast<std::size_t>(n) < sizeof(stack)) {
+        out.append(stack, static_cast<std::size_t>(n));
+        return;
+    }
+    std::size_t old = out.size();
+    out.resize(old + static_cast<std::size_t>(n) + 1);
+    std::snprintf(&out[old], static_cast<std::size_t>(n) + 1, format, args...);
+    out.resize(old + static_cast<std::size_t>(n));
+}
+#pragma GCC diagnostic pop
+
+template <class... Ts>
+struct AllTriviallyCopyable : std::true_type {};
+template <class T, class... Ts>
+struct AllTriviallyCopyable<T, Ts...>
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value && AllTriviallyCopyable<Ts...>::value> {};
+
+typedef void (*FormatFn)(const void* payload, std::string& out);
+
+template <class... Args>
+struct Payload {
+    const char* format;
+    std::tuple<Args...> args;
+};
+
+template <class... Args, std::size_t... I>
+void formatPayload(const Payload<Args...>& p, std::string& out, Indices<I...>) {
+    appendFormatted(out, p.format, std::get<I>(p.args)...);
+}
+
+// One instantiation per argument list; its address is what the producer stores next to the raw arguments
+template <class... Args>
+void formatRecord(const void* payload, std::string& out) {
+    const auto& p = *static_cast<const Payload<Args...>*>(payload);
+    formatPayload(p, out, typename MakeIndices<sizeof...(Args)>::type());
+}
+
+struct RecordHeader {
+    std::uint32_t size;    // Header + payload, a multiple of kAlign
+    FormatFn format;       // nullptr: padding up to the end of the ring
+    std::uint64_t micros;  // Wall-clock time of the log() call
+};
+
+const std::size_t kAlign = 32;  // Every record starts on a kAlign boundary, so a padding header always fits
+const std::size_t kCacheLine = 64;
+static_assert(sizeof(RecordHeader) <= kAlign, "the payload starts kAlign bytes into a record");
+
+inline std::size_t roundUp(std::size_t n) { return (n + kAlign - 1) & ~(kAlign - 1); }
+
+// Single-producer / single-consumer ring of variable-sized records; records never wrap around the end
+class ThreadBuffer {
+public:
+    explicit ThreadBuffer(std::size_t bytes) : data_(new Storage[bytes / sizeof(Storage)]), mask_(bytes - 1) {
+        if (bytes < kAlign || (bytes & (bytes - 1)) != 0) {
+            throw std::invalid_argument("log buffer size must be a power of two");
+        }
+    }
+
+    // Producer: contiguous space for size bytes, or nullptr if the ring is too full right now
+    char* reserve(std::size_t size) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t offset = tail & mask_;
+        std::size_t toEnd = capacity() - offset;
+        std::size_t needed = size <= toEnd ? size : toEnd + size;  // Wrapping wastes the rest of the ring
+        if (capacity() - (tail - cachedHead_) < needed) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (capacity() - (tail - cachedHead_) < needed) {
+                return nullptr;
+            }
+        }
+        if (size > toEnd) {
+            header(offset)->size = static_cast<std::uint32_t>(toEnd);
+            header(offset)->format = nullptr;
+            tail += toEnd;
+            pendingPadding_ = toEnd;
+            offset = 0;
+        } else {
+            pendingPadding_ = 0;
+        }
+        return bytes() + offset;
+    }
+
+    // Whether a record of size bytes can ever be reserved. A record that does not fit before the end of the ring
+    // wastes the rest of it as padding, so only records of up to half the ring fit wherever the tail happens to be.
+    bool fits(std::size_t size) const { return size <= capacity() / 2; }
+
+    void commit(std::size_t size) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed) + pendingPadding_ + size;
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    // Consumer: formats every complete record into out and returns the position after them. The space is only
+    // given back by release(), once the text has been written, so head doubles as "written up to here" for flush().
+    std::size_t drain(std::string& out) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        while (head != tail) {
+            RecordHeader* h = header(head & mask_);
+            if (h->format) {
+                appendTimestamp(out, h->micros);
+                h->format(bytes() + (head & mask_) + kAlign, out);
+            }
+            head += h->size;
+        }
+        return head;
+    }
+
+    void release(std::size_t head) { head_.store(head, std::memory_order_release); }
+
+    std::size_t tail() const { return tail_.load(std::memory_order_acquire); }
+    std::size_t written() const { return head_.load(std::memory_order_acquire); }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    std::atomic<bool> retired{false};  // The owning thread has exited
+
+private:
+    typedef std::aligned_storage<kAlign, 16>::type Storage;
+
+    char* bytes() { return reinterpret_cast<char*>(data_.get()); }
+    RecordHeader* header(std::size_t offset) { return reinterpret_cast<RecordHeader*>(bytes() + offset); }
+
+    static void appendTimestamp(std::string& out, std::uint64_t micros) {
+        char stamp[32];
+        int n = std::snprintf(stamp, sizeof(stamp), "[%llu.%06llu] ", static_cast<unsigned long long>(micros / 1000000),
+                              static_cast<unsigned long long>(micros % 1000000));
+        out.append(stamp, static_cast<std::size_t>(n));
+    }
+
+    std::unique_ptr<Storage[]> data_;
+    std::size_t mask_;
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};  // Written by the producer
+    std::size_t cachedHead_ = 0;
+    std::size_t pendingPadding_ = 0;
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};  // Written by the consumer
+};
+
+}  // namespace detail
+
+class AsyncLogger {
+public:
+    // Writes to fd (not closed by the logger); every thread that logs gets a ring of bufferBytes (a power of two)
+    explicit AsyncLogger(int fd = STDOUT_FILENO, std::size_t bufferBytes = 1 << 20)
+        : fd_(fd), bufferBytes_(bufferBytes), id_(nextId().fetch_add(1) + 1) {
+        detail::ThreadBuffer check(bufferBytes);  // Throws here rather than in the first log() call
+        writer_ = std::thread([this] { writerLoop(); });
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    ~AsyncLogger() {
+        flush();
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+
+    template <class... Args>
+    void log(const char* format, Args... args) {
+        typedef detail::Payload<Args...> Payload;
+        // The record is never destroyed, just overwritten, so the arguments must not need a destructor either
+        static_assert(detail::AllTriviallyCopyable<Args...>::value, "log() arguments must be trivially copyable");
+        static_assert(alignof(Payload) <= 16, "over-aligned log() argument");
+        const std::size_t size = detail::kAlign + detail::roundUp(sizeof(Payload));
+        detail::ThreadBuffer& buffer = threadBuffer();
+        if (!buffer.fits(size)) {
+            throw std::length_error("log() record larger than half the logger's buffer");  // Would wait forever
+        }
+        char* slot;
+        while (!(slot = buffer.reserve(size))) {
+            std::this_thread::yield();  // Full: let the writer catch up
+        }
+        auto* h = new (slot) detail::RecordHeader;
+        h->size = static_cast<std::uint32_t>(size);
+        h->format = &detail::formatRecord<Args...>;
+        h->micros = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                   std::chrono::system_clock::now().time_since_epoch())
+                                                   .count());
+        new (slot + detail::kAlign) Payload{format, std::tuple<Args...>(args...)};
+        buffer.commit(size);
+    }
+
+    // Returns once every message logged (by any thread) before the call has been written
+    void flush() {
+        std::vector<std::pair<std::shared_ptr<detail::ThreadBuffer>, std::size_t>> targets;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            for (const auto& buffer : buffers_) {
+                targets.emplace_back(buffer, buffer->tail());
+            }
+        }
+        for (const auto& target : targets) {
+            while (target.first->written() < target.second) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+private:
+    detail::ThreadBuffer& threadBuffer() {
+        // Per thread: one buffer per logger this thread has used, the most recently used first. All of them are
+        // marked retired on thread exit.
+        struct Entry {
+            std::uint64_t loggerId;
+            std::shared_ptr<detail::ThreadBuffer> buffer;
+        };
+        struct Cache {
+            std::vector<Entry> entries;
+            ~Cache() {
+                for (const auto& entry : entries) {
+                    entry.buffer->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+        static thread_local Cache cache;
+        if (!cache.entries.empty() && cache.entries.front().loggerId == id_) {
+            return *cache.entries.front().buffer;  // Fast path: same logger as last time
+        }
+        for (auto it = cache.entries.begin(); it != cache.entries.end(); ++it) {
+            if (it->loggerId == id_) {
+                std::rotate(cache.entries.begin(), it, it + 1);
+                return *cache.entries.front().buffer;
+            }
+        }
+        // A destroyed logger has dropped its references, leaving ours as the only one: forget those buffers
+        cache.entries.erase(std::remove_if(cache.entries.begin(), cache.entries.end(),
+                                           [](const Entry& e) { return e.buffer.use_count() == 1; }),
+                            cache.entries.end());
+        Entry entry{id_, std::make_shared<detail::ThreadBuffer>(bufferBytes_)};
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers_.push_back(entry.buffer);
+        }
+        cache.entries.insert(cache.entries.begin(), std::move(entry));
+        return *cache.entries.front().buffer;
+    }
+
+    void writerLoop() {
+        std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers;
+        std::vector<std::string> text;
+        std::vector<iovec> iov;
+        std::vector<std::size_t> heads;
+        while (true) {
+            bool stopping = stop_.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lock(buffersMutex_);
+                buffers = buffers_;
+            }
+            text.resize(buffers.size());
+            heads.resize(buffers.size());
+            iov.clear();
+            for (std::size_t i = 0; i < buffers.size(); ++i) {
+                text[i].clear();
+                heads[i] = buffers[i]->drain(text[i]);
+                if (!text[i].empty()) {
+                    iov.push_back(iovec{&text[i][0], text[i].size()});
+                }
+            }
+            writeAll(iov);
+            bool wrote = !iov.empty();
+            for (std::size_t i = 0; i < buffers.size(); ++i) {
+                // Retired is checked after draining, and a retired thread logs nothing more, so nothing is lost
+                bool retired = buffers[i]->retired.load(std::memory_order_acquire);
+                buffers[i]->release(heads[i]);
+                if (retired && buffers[i]->tail() == heads[i]) {
+                    std::lock_guard<std::mutex> lock(buffersMutex_);
+                    buffers_.erase(std::find(buffers_.begin(), buffers_.end(), buffers[i]));
+                }
+            }
+            if (!wrote) {
+                if (stopping) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    // One writev per sweep (split at IOV_MAX), resumed after partial writes
+    void writeAll(std::vector<iovec>& iov) {
+        std::size_t first = 0;
+        while (first < iov.size()) {
+            int count = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+            ssize_t n = writev(fd_, &iov[first], count);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;  // Nowhere to report a logging failure; drop this sweep's text
+            }
+            std::size_t left = static_cast<std::size_t>(n);
+            while (first < iov.size() && left >= iov[first].iov_len) {
+                left -= iov[first].iov_len;
+                ++first;
+            }
+            if (left > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+    }
+
+    static std::atomic<std::uint64_t>& nextId() {
+        static std::atomic<std::uint64_t> id{0};
+        return id;
+    }
+
+    int fd_;
+    std::size_t bufferBytes_;
+    std::uint64_t id_;  // Distinguishes loggers in the per-thread cache, even one created at a reused address
+    std::mutex buffersMutex_;  // Only taken when a thread logs for the first time and once per writer sweep
+    std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers_;
+    std::atomic<bool> stop_{false};
+    std::thread writer_;
+};
+
+}  // namespace logging
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+
+/*
+condition_variable.cpp hands a single bool from one thread to others. Real producer/consumer code passes a stream of
+work items between several producers and several consumers, which needs a queue - and a bounded one, so producers
+that outrun the consumers are slowed down instead of piling up items in memory. BoundedQueue from bounded_queue.h is
+that queue; the benchmark runs it with different producer/consumer ratios, one item per call and in batches of 32,
+and reports throughput and the enqueue-to-dequeue latency of sampled items.
+*/
+
+// -std=c++11 -O2 -pthread
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+struct Result {
+    double itemsPerSecond;
+    double p50Us;
+    double p99Us;
+};
+
+// Every item is its enqueue timestamp; one in 16 is checked on the consumer side for latency
+Result run(int producers, int consumers, std::size_t batch, std::size_t itemsPerProducer) {
+    BoundedQueue<std::uint64_t> queue(1024);
+    std::vector<std::vector<double>> latencies(consumers);
+    std::vector<std::thread> threads;
+
+    auto start = Clock::now();
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<std::uint64_t> items(batch);
+            std::uint64_t seen = 0;
+            while (true) {
+                std::size_t n = batch == 1 ? (queue.pop(items[0]) ? 1 : 0) : queue.popBatch(items.begin(), batch);
+                if (n == 0) {
+                    return;  // Closed and drained
+                }
+                std::uint64_t now = nowNs();
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (++seen % 16 == 0) {
+                        latencies[c].push_back((now - items[i]) / 1e3);
+                    }
+                }
+            }
+        });
+    }
+    std::vector<std::thread> producerThreads;
+    for (int p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&] {
+            std::vector<std::uint64_t> items(batch);
+            for (std::size_t sent = 0; sent < itemsPerProducer; sent += batch) {
+                std::uint64_t now = nowNs();
+                if (batch == 1) {
+                    queue.push(now);
+                } else {
+                    std::fill(items.begin(), items.end(), now);
+                    queue.pushBatch(items.begin(), items.end());
+                }
+            }
+        });
+    }
+    for (auto& t : producerThreads) {
+        t.join();
+    }
+    queue.close();
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::vector<double> all;
+    for (auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+    double total = static_cast<double>(producers) * static_cast<double>(itemsPerProducer);
+    return {total / elapsed.count(), all[all.size() / 2], all[all.size() * 99 / 100]};
+}
+
+int main() {
+    // Example 1: Back-pressure - the producer can only get 4 items ahead of the consumer
+    {
+        BoundedQueue<int> queue(4);
+        std::thread consumer([&] {
+            int item;
+            while (queue.pop(item)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));  // Slow consumer
+            }
+        });
+        auto start = Clock::now();
+        for (int i = 0; i < 20; ++i) {
+            queue.push(i);
+        }
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        std::cout << "Pushing 20 items into a queue of 4 took " << elapsed.count()
+                  << " ms (the producer waited for the consumer)\n";
+        queue.close();
+        consumer.join();
+    }
+
+    // Example 2: Throughput and latency over producer:consumer ratios, single items vs. batches of 32
+    const std::size_t itemsPerProducer = 1 << 18;
+    const int ratios[][2] = {{1, 1}, {1, 4}, {4, 1}, {4, 4}, {8, 8}};
+    std::cout << "\nP:C   batch   M items/s   p50 us    p99 us\n";
+    for (const auto& ratio : ratios) {
+        for (std::size_t batch : {std::size_t(1), std::size_t(32)}) {
+            Result r = run(ratio[0], ratio[1], batch, itemsPerProducer);
+            std::printf("%d:%-3d %5zu %11.2f %8.1f %9.1f\n", ratio[0], ratio[1], batch, r.itemsPerSecond / 1e6, r.p50Us,
+                        r.p99Us);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "futex_sync.h"
+
+/*
+BoundedQueue<T>: a fixed-capacity multi-producer / multi-consumer work queue.
+- push() blocks while the queue is full and pop() while it is empty, so fast producers are throttled instead of
+  growing memory without bound (back-pressure).
+- Blocking is adaptive: a thread that would block first spins for about a microsecond watching an atomic copy of the
+  size, because under load the other side usually makes room almost immediately. Only then does it sleep on a
+  condition_variable, and the other side only calls notify when somebody is really asleep.
+- pushBatch() / popBatch() move many items per lock acquisition, which is where most of the throughput comes from
+  when items are small.
+- close() wakes everybody: later pushes fail, pops drain what is left and then return false (or 0 for popBatch).
+T must be default-constructible and movable; the slots are a ring buffer allocated once up front.
+*/
+
+// -std=c++11 -pthread
+
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : slots_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("BoundedQueue capacity must be positive");
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    std::size_t capacity() const { return slots_.size(); }
+    std::size_t size() const { return size_.load(std::memory_order_relaxed); }  // A snapshot
+
+    // Blocks while full; returns false (and drops value) if the queue is closed
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock = lockWhen([this] { return count_ < slots_.size(); }, notFull_,
+                                                     waitingProducers_, [this] { return size() < capacity(); });
+        if (closed_) {
+            return false;
+        }
+        put(std::move(value));
+        wakeConsumers(1, lock);
+        return true;
+    }
+
+    bool tryPush(T value) {
+        std::unique_lock<std::mutex> lock(m_);
+        if (closed_ || count_ == slots_.size()) {
+            return false;
+        }
+        put(std::move(value));
+        wakeConsumers(1, lock);
+        return true;
+    }
+
+    // Pushes [first, last), taking the lock once per run of free slots; returns where it stopped (last unless closed)
+    template <class InputIt>
+    InputIt pushBatch(InputIt first, InputIt last) {
+        while (first != last) {
+            std::unique_lock<std::mutex> lock = lockWhen([this] { return count_ < slots_.size(); }, notFull_,
+                                                         waitingProducers_, [this] { return size() < capacity(); });
+            if (closed_) {
+                break;
+            }
+            std::size_t pushed = 0;
+            for (; first != last && count_ < slots_.size(); ++first, ++pushed) {
+                put(std::move(*first));
+            }
+            wakeConsumers(pushed, lock);
+        }
+        return first;
+    }
+
+    // Blocks while empty; returns false once the queue is closed and drained
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock = lockWhen([this] { return count_ > 0; }, notEmpty_, waitingConsumers_,
+                                                     [this] { return size() > 0; });
+        if (count_ == 0) {
+            return false;  // Closed
+        }
+        out = take();
+        wakeProducers(1, lock);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        std::unique_lock<std::mutex> lock(m_);
+        if (count_ == 0) {
+            return false;
+        }
+        out = take();
+        wakeProducers(1, lock);
+        return true;
+    }
+
+    // Waits for at least one item, then moves up to maxItems to out; returns how many (0 once closed and drained)
+    template <class OutputIt>
+    std::size_t popBatch(OutputIt out, std::size_t maxItems) {
+        std::unique_lock<std::mutex> lock = lockWhen([this] { return count_ > 0; }, notEmpty_, waitingConsumers_,
+                                                     [this] { return size() > 0; });
+        std::size_t popped = 0;
+        for (; popped < maxItems && count_ > 0; ++popped) {
+            *out++ = take();
+        }
+        wakeProducers(popped, lock);
+        return popped;
+    }
+
+    // Fails every later push and lets consumers drain the queue; blocked threads wake up
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            closed_ = true;
+        }
+        closedHint_.store(true, std::memory_order_relaxed);
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+private:
+    // Returns the lock once ready() holds or the queue is closed. Spins on hint() (an unlocked, approximate check)
+    // before sleeping on cv; waiting counts the sleepers so the other side can skip notify when there are none.
+    template <class Ready, class Hint>
+    std::unique_lock<std::mutex> lockWhen(Ready ready, std::condition_variable& cv, int& waiting, Hint hint) {
+        std::unique_lock<std::mutex> lock(m_);
+        if (ready() || closed_) {
+            return lock;
+        }
+        lock.unlock();
+        futex::detail::spinUntil([&] { return hint() || closedHint_.load(std::memory_order_relaxed); });
+        lock.lock();
+        while (!ready() && !closed_) {
+            ++waiting;
+            cv.wait(lock);
+            --waiting;
+        }
+        return lock;
+    }
+
+    void put(T&& value) {
+        slots_[(head_ + count_) % slots_.size()] = std::move(value);
+        ++count_;
+        size_.store(count_, std::memory_order_relaxed);
+    }
+
+    T take() {
+        T value = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        size_.store(count_, std::memory_order_relaxed);
+        return value;
+    }
+
+    // Notifying after unlocking spares the woken thread an immediate block on m_
+    void wakeConsumers(std::size_t items, std::unique_lock<std::mutex>& lock) {
+        int sleepers = waitingConsumers_;
+        lock.unlock();
+        wake(notEmpty_, sleepers, items);
+    }
+
+    void wakeProducers(std::size_t slots, std::unique_lock<std::mutex>& lock) {
+        int sleepers = waitingProducers_;
+        lock.unlock();
+        wake(notFull_, sleepers, slots);
+    }
+
+    static void wake(std::condition_variable& cv, int sleepers, std::size_t count) {
+        if (sleepers == 0 || count == 0) {
+            return;
+        }
+        if (count == 1) {
+            cv.notify_one();
+        } else {
+            cv.notify_all();
+        }
+    }
+
+    std::mutex m_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::vector<T> slots_;
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> size_{0};  // count_, readable without the lock while spinning
+    int waitingProducers_ = 0;
+    int waitingConsumers_ = 0;
+    bool closed_ = false;
+    std::atomic<bool> closedHint_{false};  // closed_, for the same purpose
+};
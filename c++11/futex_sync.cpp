@@ -0,0 +1,147 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "futex_sync.h"
+
+/*
+In condition_variable.cpp every printId thread waits on cv while holding mtx. notify_all() wakes all of them, but each
+one has to re-acquire mtx before its wait() can return, so they leave one at a time: the last thread's wake-up waits
+for every other thread's wake-up, context switch and critical section (a "thundering herd" on the mutex).
+futex::Event from futex_sync.h is the same one-shot "ready" flag without the mutex: waiters check an atomic word and
+park on it with a futex, set() flips the word and wakes them, and every woken thread returns straight away.
+The benchmark parks N threads on each primitive, releases them and measures how long it takes until the first and
+the last of them is running again.
+*/
+
+// -std=c++11 -O2 -pthread, Linux only
+
+using Clock = std::chrono::steady_clock;
+
+// Same shape as condition_variable.cpp, without the mutex on the waiting side
+futex::Event ready;
+
+void printId(int id) {
+    ready.wait();
+    std::cout << "Thread " + std::to_string(id) + " is running\n";
+}
+
+// The condition_variable version from condition_variable.cpp, packaged for the benchmark
+struct CvEvent {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return ready; });
+    }
+    void set() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ready = true;
+        }
+        cv.notify_all();
+    }
+};
+
+struct Latency {
+    double firstUs;
+    double lastUs;
+};
+
+// Parks threads waiters on a fresh Event, releases them and returns when the first and the last one woke up
+template <class Event>
+Latency measureWakeUp(int threads) {
+    Event event;
+    futex::Latch parked(static_cast<std::uint32_t>(threads));
+    std::vector<Clock::time_point> wokeAt(threads);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < threads; ++i) {
+        waiters.emplace_back([&, i] {
+            parked.countDown();
+            event.wait();
+            wokeAt[i] = Clock::now();
+        });
+    }
+    parked.wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));  // Long enough for every waiter to stop spinning
+    Clock::time_point released = Clock::now();
+    event.set();
+    for (auto& t : waiters) {
+        t.join();
+    }
+    auto first = *std::min_element(wokeAt.begin(), wokeAt.end());
+    auto last = *std::max_element(wokeAt.begin(), wokeAt.end());
+    return {std::chrono::duration<double, std::micro>(first - released).count(),
+            std::chrono::duration<double, std::micro>(last - released).count()};
+}
+
+// Median over several rounds; a single round is at the mercy of the scheduler
+template <class Event>
+Latency medianWakeUp(int threads, int rounds) {
+    std::vector<double> first, last;
+    for (int r = 0; r < rounds; ++r) {
+        Latency l = measureWakeUp<Event>(threads);
+        first.push_back(l.firstUs);
+        last.push_back(l.lastUs);
+    }
+    std::sort(first.begin(), first.end());
+    std::sort(last.begin(), last.end());
+    return {first[first.size() / 2], last[last.size() / 2]};
+}
+
+int main() {
+    // Example 1: condition_variable.cpp with futex::Event
+    {
+        std::thread t1(printId, 1);
+        std::thread t2(printId, 2);
+        std::thread t3(printId, 3);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ready.set();
+        t1.join();
+        t2.join();
+        t3.join();
+    }
+
+    // Example 2: Latch for one-shot fan-in, Barrier for repeated phases
+    {
+        const int workers = 4;
+        futex::Latch done(workers);
+        futex::Barrier phase(workers);
+        std::vector<int> progress(workers, 0);
+        std::vector<std::thread> pool;
+        for (int i = 0; i < workers; ++i) {
+            pool.emplace_back([&, i] {
+                for (int step = 0; step < 3; ++step) {
+                    progress[i] = step + 1;
+                    phase.arriveAndWait();  // No worker starts step + 1 before all finished step
+                }
+                done.countDown();
+            });
+        }
+        done.wait();
+        std::cout << "All " << workers << " workers finished 3 phases: " << progress[0] << progress[1] << progress[2]
+                  << progress[3] << "\n";
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+
+    // Example 3: Wake-up latency of parked waiters as their number grows (median of 20 rounds, microseconds)
+    const int maxThreads = std::max(16, 2 * static_cast<int>(std::thread::hardware_concurrency()));
+    std::cout << "\nthreads   cv first   cv last   futex first   futex last\n";
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Latency cv = medianWakeUp<CvEvent>(threads, 20);
+        Latency fx = medianWakeUp<futex::Event>(threads, 20);
+        std::printf("%7d %10.1f %9.1f %13.1f %12.1f\n", threads, cv.firstUs, cv.lastUs, fx.firstUs, fx.lastUs);
+    }
+
+    return 0;
+}
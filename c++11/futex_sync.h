@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/*
+Event, Latch and Barrier built directly on the Linux futex system call.
+- A futex is a 32-bit word in ordinary memory plus a kernel wait queue keyed by its address. FUTEX_WAIT sleeps only
+  if the word still holds the value the caller expects, so "check the flag, then sleep" cannot miss a wake-up and no
+  mutex is needed to protect the flag.
+- Waiters first spin for a short while (a release that is about to happen costs no system call at all), then park.
+- The releasing side makes a system call only if somebody is actually parked: every primitive records "there are
+  sleepers" in its futex word (or a counter next to it) before a thread goes to sleep.
+- Woken threads return immediately instead of queueing on a mutex one after another, as the threads released by
+  condition_variable::notify_all do.
+*/
+
+// -std=c++11 -pthread, Linux only
+
+namespace futex {
+
+namespace detail {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words must be plain 32-bit ints");
+
+// Sleeps while *word == expected (returns at once if it is not, or spuriously)
+inline void wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+inline void wakeAll(std::atomic<std::uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void wakeOne(std::atomic<std::uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+// Tells the core we are spinning (frees pipeline resources for the sibling hyper-thread)
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+const int kSpinLimit = 200;  // About a microsecond of spinning before parking
+
+// Spins until done() holds or the spin budget runs out; returns done()
+template <class Predicate>
+bool spinUntil(Predicate done) {
+    for (int i = 0; i < kSpinLimit; ++i) {
+        if (done()) {
+            return true;
+        }
+        cpuRelax();
+    }
+    return done();
+}
+
+}  // namespace detail
+
+// One-shot flag: wait() blocks until set() has been called; every later wait() returns immediately
+class Event {
+public:
+    Event() : state_(kUnset) {}
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    void set() {
+        if (state_.exchange(kSet, std::memory_order_release) == kUnsetWithWaiters) {
+            detail::wakeAll(state_);
+        }
+    }
+
+    bool isSet() const { return state_.load(std::memory_order_acquire) == kSet; }
+
+    void wait() {
+        if (detail::spinUntil([this] { return isSet(); })) {
+            return;
+        }
+        while (true) {
+            std::uint32_t s = state_.load(std::memory_order_acquire);
+            if (s == kSet) {
+                return;
+            }
+            if (s == kUnset && !state_.compare_exchange_weak(s, kUnsetWithWaiters, std::memory_order_acquire)) {
+                continue;
+            }
+            detail::wait(state_, kUnsetWithWaiters);
+        }
+    }
+
+private:
+    static const std::uint32_t kUnset = 0;
+    static const std::uint32_t kSet = 1;
+    static const std::uint32_t kUnsetWithWaiters = 2;
+
+    std::atomic<std::uint32_t> state_;
+};
+
+// Single-use countdown (like C++20 std::latch): wait() returns once countDown() has been called count times
+class Latch {
+public:
+    explicit Latch(std::uint32_t count) : word_(count) {}
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    void countDown(std::uint32_t n = 1) {
+        // The count sits in the low bits, so subtracting never touches the waiters bit
+        std::uint32_t old = word_.fetch_sub(n, std::memory_order_acq_rel);
+        if ((old & kCountMask) == n && (old & kWaitersBit)) {
+            detail::wakeAll(word_);
+        }
+    }
+
+    bool tryWait() const { return (word_.load(std::memory_order_acquire) & kCountMask) == 0; }
+
+    void wait() {
+        if (detail::spinUntil([this] { return tryWait(); })) {
+            return;
+        }
+        while (true) {
+            std::uint32_t w = word_.load(std::memory_order_acquire);
+            if ((w & kCountMask) == 0) {
+                return;
+            }
+            if (!(w & kWaitersBit) && !word_.compare_exchange_weak(w, w | kWaitersBit, std::memory_order_acquire)) {
+                continue;
+            }
+            detail::wait(word_, w | kWaitersBit);
+        }
+    }
+
+    void arriveAndWait() {
+        countDown();
+        wait();
+    }
+
+private:
+    static const std::uint32_t kWaitersBit = 1u << 31;
+    static const std::uint32_t kCountMask = kWaitersBit - 1;
+
+    std::atomic<std::uint32_t> word_;
+};
+
+// Reusable rendezvous for a fixed number of threads (like C++20 std::barrier without a completion function)
+class Barrier {
+public:
+    explicit Barrier(std::uint32_t count) : count_(count), arrived_(0), generation_(0), sleepers_(0) {}
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    void arriveAndWait() {
+        std::uint32_t gen = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            // Last to arrive: nobody else can arrive before the generation moves on, so the reset is not racy
+            arrived_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+                detail::wakeAll(generation_);
+            }
+            return;
+        }
+        auto released = [this, gen] { return generation_.load(std::memory_order_acquire) != gen; };
+        if (detail::spinUntil(released)) {
+            return;
+        }
+        // seq_cst on both sides: either the releaser sees our sleepers_ increment or we see the new generation
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        while (generation_.load(std::memory_order_seq_cst) == gen) {
+            detail::wait(generation_, gen);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    const std::uint32_t count_;
+    std::atomic<std::uint32_t> arrived_;
+    std::atomic<std::uint32_t> generation_;  // Futex word: changes once per phase
+    std::atomic<std::uint32_t> sleepers_;
+};
+
+}  // namespace futex
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lockfree_future.h"
+
+/*
+promise_future.cpp with lockfree::Promise / lockfree::Future from lockfree_future.h. computeSquare() is the same
+apart from the type of its promise. Future::then() adds what std::future lacks: "when the value is there, do this
+with it" without a thread blocking in get() in the meantime.
+The benchmark measures promise/future pairs per second for both implementations, once with the value set and read
+on the same thread (the cost of the shared state itself) and once handed over from another thread.
+*/
+
+// -std=c++11 -O2 -pthread, Linux only
+
+using Clock = std::chrono::steady_clock;
+
+// Function to perform a task and set the result in the promise
+void computeSquare(lockfree::Promise<int>&& promise, int x) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Simulate some work
+    int result = x * x;
+    promise.setValue(result);  // Set the computed result
+}
+
+double millionsPerSecond(int count, Clock::time_point start) {
+    return count / std::chrono::duration<double>(Clock::now() - start).count() / 1e6;
+}
+
+// Create, set and get on one thread
+template <class P>
+double sameThread(int count) {
+    long sum = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        P promise;
+        auto future = promise.get_future();
+        promise.set_value(i);
+        sum += future.get();
+    }
+    double rate = millionsPerSecond(count, start);
+    return sum == -1 ? 0 : rate;  // Keep the loop from being optimized away
+}
+
+// A producer thread fulfils the promises in order while this thread waits on the futures
+template <class P, class F>
+double crossThread(int count) {
+    std::vector<P> promises(count);
+    std::vector<F> futures;
+    futures.reserve(count);
+    auto start = Clock::now();
+    for (auto& p : promises) {
+        futures.push_back(p.get_future());
+    }
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            promises[i].set_value(i);
+        }
+    });
+    long sum = 0;
+    for (auto& f : futures) {
+        sum += f.get();
+    }
+    producer.join();
+    double rate = millionsPerSecond(count, start);
+    return sum == -1 ? 0 : rate;
+}
+
+// Same names as std::promise, so the benchmark templates can take either
+struct FastPromise : lockfree::Promise<int> {
+    lockfree::Future<int> get_future() { return getFuture(); }
+    void set_value(int v) { setValue(v); }
+};
+
+int main() {
+    // Example 1: promise_future.cpp
+    {
+        lockfree::Promise<int> promise;
+        lockfree::Future<int> future = promise.getFuture();
+        std::thread t(computeSquare, std::move(promise), 5);
+        std::cout << "Waiting for the result...\n";
+        int result = future.get();  // Blocks the calling (main) thread until value is available
+        std::cout << "The square of 5 is: " << result << std::endl;
+        t.join();
+    }
+
+    // Example 2: Continuations - the main thread never waits for the square itself
+    {
+        lockfree::Promise<int> promise;
+        lockfree::Future<std::string> message =
+            promise.getFuture()
+                .then([](int square) { return square + 1; })
+                .then([](int n) { return "square plus one is " + std::to_string(n); });
+        std::thread t(computeSquare, std::move(promise), 6);  // The continuations run on this thread
+        std::cout << "Continuations attached, " << message.get() << std::endl;
+        t.join();
+
+        lockfree::Promise<int> failing;
+        lockfree::Future<int> skipped = failing.getFuture().then([](int n) { return n * 2; });
+        failing.setException(std::make_exception_ptr(std::runtime_error("computation failed")));
+        try {
+            skipped.get();
+        } catch (const std::exception& e) {
+            std::cout << "Exception passed through then(): " << e.what() << std::endl;
+        }
+    }
+
+    // Example 3: Promise/future pairs per second
+    const int count = 1000000;
+    std::printf("\n%-28s %14s %14s\n", "M futures/s", "std::future", "lockfree");
+    std::printf("%-28s %14.2f %14.2f\n", "same thread",
+                sameThread<std::promise<int>>(count), sameThread<FastPromise>(count));
+    std::printf("%-28s %14.2f %14.2f\n", "from another thread",
+                crossThread<std::promise<int>, std::future<int>>(count),
+                crossThread<FastPromise, lockfree::Future<int>>(count));
+
+    long sum = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        lockfree::Promise<int> promise;
+        lockfree::Future<int> next = promise.getFuture().then([](int v) { return v + 1; });
+        promise.setValue(i);
+        sum += next.get();
+    }
+    std::printf("%-28s %14s %14.2f\n", "with one then()", "-", sum == -1 ? 0 : millionsPerSecond(count, start));
+
+    return 0;
+}
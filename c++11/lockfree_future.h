@@ -0,0 +1,303 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "futex_sync.h"
+
+/*
+A promise/future pair without a mutex or condition_variable. std::promise keeps its value in a heap-allocated shared
+state that also holds a mutex and a condition variable, and every set_value()/get() goes through that mutex.
+Here the shared state is one allocation whose synchronization is a single 32-bit atomic word:
+- a few flag bits: value set, exception set, continuation attached, a thread sleeping in wait()
+- and, in the bits above them, the reference count of the promise and the future.
+setValue() constructs the result in place in the state and sets "value set" with one atomic OR; the old word tells
+it whether anybody has to be woken (futex, only if a thread actually sleeps) and whether a continuation is waiting.
+Future::then(f) attaches f to run when the value arrives - on the thread that calls setValue(), or immediately if the
+value is already there - and returns a future for f's result, so nobody blocks waiting for the intermediate value.
+Continuations whose captures are small are stored inside the shared state as well; only large ones are allocated
+separately.
+Continuations run inline: a long chain of then() set off at once runs as nested calls, on one thread's stack.
+T must not be void or a reference, and then()'s callable must return a value.
+*/
+
+// -std=c++11 -pthread, Linux only (futex)
+
+namespace lockfree {
+
+template <class T>
+class Promise;
+template <class T>
+class Future;
+
+namespace detail {
+
+// Layout of the state word
+const std::uint32_t kValue = 1;
+const std::uint32_t kException = 2;
+const std::uint32_t kContinuation = 4;
+const std::uint32_t kWaiter = 8;        // Somebody may be sleeping on the word
+const std::uint32_t kFutureTaken = 16;  // getFuture() has been called
+const std::uint32_t kReady = kValue | kException;
+const std::uint32_t kRef = 32;          // One reference, counted in the bits above the flags
+
+const std::size_t kInlineContinuationBytes = 48;
+
+template <class T>
+class State;
+
+template <class T>
+struct ContinuationBase {
+    virtual ~ContinuationBase() {}
+    virtual void run(State<T>& source) = 0;
+};
+
+template <class T>
+class State {
+public:
+    State() : word_(kRef), continuation_(nullptr) {}  // The promise's reference
+    State(const State&) = delete;
+    State& operator=(const State&) = delete;
+
+    ~State() {
+        if (word_.load(std::memory_order_relaxed) & kValue) {
+            value().~T();
+        }
+        destroyContinuation();
+    }
+
+    std::uint32_t load() const { return word_.load(std::memory_order_acquire); }
+
+    // Called by the promise once: adds the future's reference
+    void takeFuture() {
+        if (load() & kFutureTaken) {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        word_.fetch_add(kRef | kFutureTaken, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (word_.fetch_sub(kRef, std::memory_order_acq_rel) < 2 * kRef) {
+            delete this;
+        }
+    }
+
+    template <class... Args>
+    void setValue(Args&&... args) {
+        checkUnsatisfied();
+        new (&value_) T(std::forward<Args>(args)...);
+        publish(kValue);
+    }
+
+    void setException(std::exception_ptr error) {
+        checkUnsatisfied();
+        error_ = error;
+        publish(kException);
+    }
+
+    void wait() {
+        if (futex::detail::spinUntil([this] { return (load() & kReady) != 0; })) {
+            return;
+        }
+        while (true) {
+            std::uint32_t word = word_.fetch_or(kWaiter, std::memory_order_acquire) | kWaiter;
+            if (word & kReady) {
+                return;
+            }
+            futex::detail::wait(word_, word);  // Returns early if the word changed, e.g. a reference was dropped
+        }
+    }
+
+    T& value() { return *reinterpret_cast<T*>(&value_); }
+    std::exception_ptr error() const { return error_; }
+
+    // Takes ownership of the future's side: c runs exactly once, here or in publish(), whichever comes second
+    template <class C, class... Args>
+    void attach(Args&&... args) {
+        if (sizeof(C) <= kInlineContinuationBytes && alignof(C) <= alignof(std::max_align_t)) {
+            continuation_ = new (&inlineContinuation_) C(std::forward<Args>(args)...);
+        } else {
+            continuation_ = new C(std::forward<Args>(args)...);
+        }
+        if (word_.fetch_or(kContinuation, std::memory_order_acq_rel) & kReady) {
+            runContinuation();
+        }
+    }
+
+private:
+    void checkUnsatisfied() const {
+        if (word_.load(std::memory_order_relaxed) & kReady) {  // Only the promise sets, so no race here
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+
+    void publish(std::uint32_t flag) {
+        std::uint32_t old = word_.fetch_or(flag, std::memory_order_acq_rel);
+        if (old & kWaiter) {
+            futex::detail::wakeAll(word_);
+        }
+        if (old & kContinuation) {
+            runContinuation();
+        }
+    }
+
+    void runContinuation() {
+        continuation_->run(*this);
+        destroyContinuation();  // Frees the captures now rather than when the last reference goes
+    }
+
+    void destroyContinuation() {
+        if (continuation_ == reinterpret_cast<ContinuationBase<T>*>(&inlineContinuation_)) {
+            continuation_->~ContinuationBase<T>();
+        } else {
+            delete continuation_;
+        }
+        continuation_ = nullptr;
+    }
+
+    std::atomic<std::uint32_t> word_;
+    ContinuationBase<T>* continuation_;  // Written before kContinuation is set, read after it is seen
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+    std::exception_ptr error_;
+    typename std::aligned_storage<kInlineContinuationBytes, alignof(std::max_align_t)>::type inlineContinuation_;
+};
+
+// Runs f on the source's value and fulfils the promise of the future then() returned
+template <class T, class F, class U>
+struct Continuation : ContinuationBase<T> {
+    template <class G>
+    Continuation(G&& g, Promise<U>&& next) : f(std::forward<G>(g)), promise(std::move(next)) {}
+
+    void run(State<T>& source) override {
+        if (source.load() & kException) {
+            promise.setException(source.error());
+            return;
+        }
+        try {
+            promise.setValue(f(std::move(source.value())));
+        } catch (...) {
+            promise.setException(std::current_exception());
+        }
+    }
+
+    F f;
+    Promise<U> promise;
+};
+
+}  // namespace detail
+
+template <class T>
+class Promise {
+public:
+    Promise() : state_(new detail::State<T>) {}
+    Promise(Promise&& other) noexcept : state_(other.state_) { other.state_ = nullptr; }
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = other.state_;
+            other.state_ = nullptr;
+        }
+        return *this;
+    }
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+    ~Promise() { abandon(); }
+
+    Future<T> getFuture() {
+        state_->takeFuture();
+        return Future<T>(state_);
+    }
+
+    void setValue(const T& value) { state_->setValue(value); }
+    void setValue(T&& value) { state_->setValue(std::move(value)); }
+    void setException(std::exception_ptr error) { state_->setException(error); }
+
+private:
+    // Like std::promise: a promise destroyed without a result leaves a broken_promise error in the future
+    void abandon() {
+        if (state_ == nullptr) {
+            return;
+        }
+        if (!(state_->load() & detail::kReady)) {
+            state_->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+        state_->release();
+        state_ = nullptr;
+    }
+
+    detail::State<T>* state_;
+};
+
+template <class T>
+class Future {
+public:
+    Future() : state_(nullptr) {}
+    Future(Future&& other) noexcept : state_(other.state_) { other.state_ = nullptr; }
+    Future& operator=(Future&& other) noexcept {
+        if (this != &other) {
+            if (state_) {
+                state_->release();
+            }
+            state_ = other.state_;
+            other.state_ = nullptr;
+        }
+        return *this;
+    }
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    ~Future() {
+        if (state_) {
+            state_->release();
+        }
+    }
+
+    bool valid() const { return state_ != nullptr; }
+    bool isReady() const { return (state_->load() & detail::kReady) != 0; }
+
+    // Blocks until the value or exception is there: spins briefly, then sleeps on the state word
+    void wait() const { state_->wait(); }
+
+    // Waits, then moves the value out (or rethrows the exception). The future is invalid afterwards.
+    T get() {
+        wait();
+        detail::State<T>* state = state_;
+        state_ = nullptr;
+        if (state->load() & detail::kException) {
+            std::exception_ptr error = state->error();
+            state->release();
+            std::rethrow_exception(error);
+        }
+        T result(std::move(state->value()));
+        state->release();
+        return result;
+    }
+
+    // Returns a future for f(value), computed when the value arrives. An exception skips f and is passed on.
+    // The future is invalid afterwards.
+    template <class F>
+    Future<typename std::decay<decltype(std::declval<F&>()(std::declval<T>()))>::type> then(F&& f) {
+        typedef typename std::decay<decltype(std::declval<F&>()(std::declval<T>()))>::type U;
+        typedef detail::Continuation<T, typename std::decay<F>::type, U> C;
+        Promise<U> next;
+        Future<U> result = next.getFuture();
+        detail::State<T>* state = state_;
+        state_ = nullptr;
+        state->template attach<C>(std::forward<F>(f), std::move(next));
+        state->release();  // The promise side keeps the state alive until the continuation has run
+        return result;
+    }
+
+private:
+    friend class Promise<T>;
+    explicit Future(detail::State<T>* state) : state_(state) {}
+
+    detail::State<T>* state_;
+};
+
+}  // namespace lockfree
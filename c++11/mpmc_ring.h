@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+MpmcRing<T>: a bounded, lock-free multi-producer / multi-consumer queue (Dmitry Vyukov's sequence-numbered ring).
+- Every slot carries a sequence number that says whose turn it is. For position pos the slot pos & mask is free for
+  the producer of pos when seq == pos, and holds a value for the consumer of pos when seq == pos + 1. After the
+  consumer is done it sets seq = pos + capacity, handing the slot to the producer of the next lap.
+- A producer claims a position with one CAS on the tail counter and a consumer with one CAS on the head counter;
+  the slot's sequence number then publishes the data, so producers and consumers never touch the same counter.
+- head and tail live on separate cache lines, otherwise every push would invalidate the line all consumers spin on.
+- tryPush/tryPop never block: they return false when the ring is full/empty. tryPushBulk/tryPopBulk claim a run of
+  consecutive slots with a single CAS and return how many items they moved.
+Capacity is rounded up to a power of two.
+*/
+
+// -std=c++11
+
+template <class T>
+class MpmcRing {
+public:
+    explicit MpmcRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        slots_.reset(new Slot[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    ~MpmcRing() {
+        // No other thread may use the ring any more, so every position in [head, tail) holds a value
+        std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        for (std::size_t pos = head_.value.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            reinterpret_cast<T*>(&slots_[pos & mask_].storage)->~T();
+        }
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    bool tryPush(T value) { return tryPushBulk(&value, 1) == 1; }
+    bool tryPop(T& out) { return tryPopBulk(&out, 1) == 1; }
+
+    // Moves up to n items from first into the ring; returns how many were pushed (0 when full)
+    template <class InputIt>
+    std::size_t tryPushBulk(InputIt first, std::size_t n) {
+        std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        while (true) {
+            claimed = countSlots(pos, n, 0);
+            if (claimed == 0) {
+                std::size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+                if (static_cast<std::intptr_t>(seq - pos) < 0) {
+                    return 0;  // The slot still holds last lap's value: full
+                }
+                pos = tail_.value.load(std::memory_order_relaxed);  // Another producer got there first
+                continue;
+            }
+            if (tail_.value.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (std::size_t i = 0; i < claimed; ++i, ++first) {
+            Slot& slot = slots_[(pos + i) & mask_];
+            new (&slot.storage) T(std::move(*first));
+            slot.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Moves up to n items into out; returns how many were popped (0 when empty)
+    template <class OutputIt>
+    std::size_t tryPopBulk(OutputIt out, std::size_t n) {
+        std::size_t pos = head_.value.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        while (true) {
+            claimed = countSlots(pos, n, 1);
+            if (claimed == 0) {
+                std::size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+                if (static_cast<std::intptr_t>(seq - (pos + 1)) < 0) {
+                    return 0;  // Not written yet: empty
+                }
+                pos = head_.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (head_.value.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (std::size_t i = 0; i < claimed; ++i) {
+            Slot& slot = slots_[(pos + i) & mask_];
+            T* value = reinterpret_cast<T*>(&slot.storage);
+            *out++ = std::move(*value);
+            value->~T();
+            slot.seq.store(pos + i + capacity(), std::memory_order_release);
+        }
+        return claimed;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static const std::size_t kCacheLine = 64;
+
+    struct alignas(kCacheLine) PaddedCounter {
+        std::atomic<std::size_t> value{0};
+        char padding[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    };
+
+    // Number of consecutive slots from pos (at most n) that are ready: seq == pos + i + offset.
+    // A slot that is ready stays ready until the owner of its position claims it, so the count stays valid
+    // for as long as the CAS that claims the run succeeds.
+    std::size_t countSlots(std::size_t pos, std::size_t n, std::size_t offset) const {
+        std::size_t count = 0;
+        while (count < n && count <= mask_ &&
+               slots_[(pos + count) & mask_].seq.load(std::memory_order_acquire) == pos + count + offset) {
+            ++count;
+        }
+        return count;
+    }
+
+    PaddedCounter head_;  // Next position to pop
+    PaddedCounter tail_;  // Next position to push
+    std::size_t mask_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+};
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ProfiledMutex: a std::mutex that keeps statistics about how it is used, so hot locks can be found in production.
+- Drop-in: it has lock() / unlock() / try_lock(), so std::lock_guard, std::unique_lock and std::lock work with it.
+- Every mutex belongs to a lock site, a name given at construction (PROFILED_MUTEX_SITE gives "file:line").
+  Mutexes created with the same name, e.g. one per object of a class, are reported together; the statistics of a
+  destroyed mutex are folded into its site, so short-lived locks still show up.
+- Per site: acquisitions, contended acquisitions (try_lock failed, so the thread had to wait), and log2 histograms of
+  the wait time of contended acquisitions and of the hold time (lock() to unlock()).
+- Cheap enough to leave on: an uncontended lock() is try_lock() plus one timestamp; time is read with rdtsc on x86
+  and only converted to nanoseconds when the report is printed. Each mutex has its own counters and only updates
+  them while it is held, so they need no atomic read-modify-write instructions and no extra cache-line traffic.
+- A report of every site, busiest first, is written to stderr at program exit; ProfiledMutex::report() prints one
+  at any other time.
+*/
+
+// -std=c++11 -pthread
+
+namespace profiling {
+
+// Raw timestamp: TSC cycles on x86, steady_clock nanoseconds elsewhere
+inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+const int kBuckets = 48;  // Bucket b counts durations in [2^(b-1), 2^b) ticks; bucket 0 is "0 ticks"
+
+inline int bucketOf(std::uint64_t t) {
+    int b = 0;
+    while (t != 0 && b < kBuckets - 1) {
+        t >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+// A counter with a single writer at a time (the lock owner): relaxed load + store compiles to a plain increment,
+// while report() may still read it from another thread
+class Counter {
+public:
+    Counter() : value_(0) {}
+    void add(std::uint64_t n) { value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    std::uint64_t load() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_;
+};
+
+struct Histogram {
+    Counter counts[kBuckets];
+    Counter totalTicks;
+
+    void add(std::uint64_t t) {
+        counts[bucketOf(t)].add(1);
+        totalTicks.add(t);
+    }
+
+    void merge(const Histogram& other) {
+        for (int b = 0; b < kBuckets; ++b) {
+            counts[b].add(other.counts[b].load());
+        }
+        totalTicks.add(other.totalTicks.load());
+    }
+
+    // Upper bound (in ticks) of the bucket that contains the q-quantile
+    std::uint64_t quantile(double q) const {
+        std::uint64_t total = 0;
+        for (const auto& c : counts) {
+            total += c.load();
+        }
+        std::uint64_t rank = static_cast<std::uint64_t>(q * total), seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += counts[b].load();
+            if (seen > rank) {
+                return b == 0 ? 0 : (std::uint64_t(1) << b) - 1;
+            }
+        }
+        return 0;
+    }
+};
+
+struct LockStats {
+    Counter acquisitions;
+    Counter contended;
+    Histogram wait;  // Contended acquisitions only
+    Histogram hold;
+
+    void merge(const LockStats& other) {
+        acquisitions.add(other.acquisitions.load());
+        contended.add(other.contended.load());
+        wait.merge(other.wait);
+        hold.merge(other.hold);
+    }
+};
+
+// Knows every live mutex and keeps the merged statistics of destroyed ones, per site
+class Registry {
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    void add(const std::string& site, LockStats* stats) {
+        std::lock_guard<std::mutex> lock(m_);
+        live_.insert(std::make_pair(stats, site));
+        retired_[site];  // The site is listed even if none of its mutexes is ever locked
+    }
+
+    void remove(LockStats* stats) {
+        std::lock_guard<std::mutex> lock(m_);
+        auto it = live_.find(stats);
+        retired_[it->second].merge(*stats);
+        live_.erase(it);
+    }
+
+    void report(std::FILE* out) {
+        std::lock_guard<std::mutex> lock(m_);
+        double nsPerTick = calibrate();
+        std::map<std::string, LockStats> sites;
+        for (auto& entry : retired_) {
+            sites[entry.first].merge(entry.second);
+        }
+        for (auto& entry : live_) {
+            sites[entry.second].merge(*entry.first);
+        }
+        std::vector<std::pair<const std::string, LockStats>*> sorted;
+        for (auto& entry : sites) {
+            sorted.push_back(&entry);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<const std::string, LockStats>* a,
+                                                   const std::pair<const std::string, LockStats>* b) {
+            return a->second.hold.totalTicks.load() > b->second.hold.totalTicks.load();
+        });
+        std::fprintf(out, "%-40s %12s %10s %9s %11s %11s %11s %11s %11s\n", "lock site", "acquisitions", "contended",
+                     "contended%", "wait total", "wait p99", "hold total", "hold p50", "hold p99");
+        for (auto* entry : sorted) {
+            const LockStats* s = &entry->second;
+            std::uint64_t n = s->acquisitions.load(), c = s->contended.load();
+            std::fprintf(out, "%-40s %12llu %10llu %8.2f%% %9.3fms %9.0fns %9.3fms %9.0fns %9.0fns\n",
+                         entry->first.c_str(),
+                         static_cast<unsigned long long>(n), static_cast<unsigned long long>(c),
+                         n ? 100.0 * c / n : 0.0, s->wait.totalTicks.load() * nsPerTick / 1e6,
+                         s->wait.quantile(0.99) * nsPerTick, s->hold.totalTicks.load() * nsPerTick / 1e6,
+                         s->hold.quantile(0.5) * nsPerTick, s->hold.quantile(0.99) * nsPerTick);
+        }
+    }
+
+private:
+    Registry() : startTicks_(ticks()), startTime_(std::chrono::steady_clock::now()) {}
+
+    ~Registry() {
+        if (!retired_.empty()) {
+            std::fprintf(stderr, "\n=== lock profile ===\n");
+            report(stderr);
+        }
+    }
+
+    // Tick length measured over the program's lifetime so far, so no start-up delay is needed
+    double calibrate() const {
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - startTime_;
+        std::uint64_t t = ticks() - startTicks_;
+        return t ? elapsed.count() / t : 1.0;
+    }
+
+    std::mutex m_;
+    std::map<LockStats*, std::string> live_;
+    std::map<std::string, LockStats> retired_;
+    std::uint64_t startTicks_;
+    std::chrono::steady_clock::time_point startTime_;
+};
+
+}  // namespace profiling
+
+#define PROFILED_MUTEX_STRINGIFY2(x) #x
+#define PROFILED_MUTEX_STRINGIFY(x) PROFILED_MUTEX_STRINGIFY2(x)
+// "file:line" of the place where it is expanded, as a lock site name
+#define PROFILED_MUTEX_SITE __FILE__ ":" PROFILED_MUTEX_STRINGIFY(__LINE__)
+
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const std::string& site = "unnamed") { profiling::Registry::instance().add(site, &stats_); }
+    ~ProfiledMutex() { profiling::Registry::instance().remove(&stats_); }
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        if (m_.try_lock()) {
+            acquired(profiling::ticks());
+            return;
+        }
+        std::uint64_t start = profiling::ticks();
+        m_.lock();
+        std::uint64_t now = profiling::ticks();
+        stats_.contended.add(1);
+        stats_.wait.add(now - start);
+        acquired(now);
+    }
+
+    bool try_lock() {
+        if (!m_.try_lock()) {
+            return false;
+        }
+        acquired(profiling::ticks());
+        return true;
+    }
+
+    void unlock() {
+        stats_.hold.add(profiling::ticks() - lockedAt_);
+        m_.unlock();
+    }
+
+    static void report(std::FILE* out = stderr) { profiling::Registry::instance().report(out); }
+
+private:
+    void acquired(std::uint64_t now) {
+        lockedAt_ = now;  // Only read by unlock(), which runs in the same critical section
+        stats_.acquisitions.add(1);
+    }
+
+    std::mutex m_;
+    profiling::LockStats stats_;
+    std::uint64_t lockedAt_ = 0;
+};
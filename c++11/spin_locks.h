@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "futex_sync.h"
+
+/*
+Three alternatives to std::mutex, all usable with std::lock_guard / std::unique_lock (lock(), unlock(), try_lock()).
+- TicketLock: like the ticket dispenser at a deli counter. lock() takes a number with one fetch_add and waits until
+  it is served, so threads get the lock strictly in arrival order (FIFO, no starvation). Waiters still all spin on
+  the same "now serving" word, so every release invalidates that cache line in every waiting core; each waiter
+  backs off in proportion to its distance from the front to soften this.
+- McsLock (Mellor-Crummey & Scott): waiters form a linked queue and each one spins on a flag in its own queue node,
+  on its own cache line. A release writes only the successor's flag, so the cost of a hand-off does not grow with
+  the number of waiters - this is the lock that scales to many cores. FIFO as well.
+- AdaptiveSpinMutex: a test-and-test-and-set lock that spins with exponential backoff for a short while and then
+  sleeps on a futex, so waiters do not burn CPU while the holder is preempted or the critical section is long.
+  Not FIFO: a running thread can grab the lock before a sleeping one wakes up, which is good for throughput.
+The pure spin locks (ticket, MCS) assume at most one thread per core: a waiter spinning while the holder - or, for
+FIFO locks, the next thread in line - is descheduled wastes its time slice. To keep that from turning into a livelock
+on an oversubscribed machine, a waiter yields the CPU after every few thousand unsuccessful spins.
+*/
+
+// -std=c++11 -pthread, Linux only (futex)
+
+namespace locks {
+
+namespace detail {
+
+// One step of a spin-wait loop: a pause instruction, plus a yield every kYieldEvery calls
+inline void spinPause(std::uint32_t& spins) {
+    const std::uint32_t kYieldEvery = 4096;
+    if (++spins % kYieldEvery == 0) {
+        std::this_thread::yield();
+    } else {
+        futex::detail::cpuRelax();
+    }
+}
+
+}  // namespace detail
+
+class TicketLock {
+public:
+    TicketLock() : next_(0), serving_(0) {}
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+
+    void lock() {
+        std::uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        std::uint32_t spins = 0;
+        while (true) {
+            std::uint32_t serving = serving_.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+            // Proportional backoff: the further back in line, the longer until it is our turn
+            for (std::uint32_t i = 0; i < (ticket - serving) * 32; ++i) {
+                detail::spinPause(spins);
+            }
+        }
+    }
+
+    bool try_lock() {
+        std::uint32_t serving = serving_.load(std::memory_order_relaxed);
+        std::uint32_t expected = serving;
+        // Succeeds only if nobody holds or waits for the lock: the next ticket is the one being served
+        return next_.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void unlock() {
+        // Only the holder writes serving_, so a plain load + store is enough
+        serving_.store(serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    alignas(64) std::atomic<std::uint32_t> next_;
+    alignas(64) std::atomic<std::uint32_t> serving_;  // Separate line: waiters spin here while newcomers take tickets
+};
+
+class McsLock {
+public:
+    McsLock() : tail_(nullptr), holder_(nullptr) {}
+    McsLock(const McsLock&) = delete;
+    McsLock& operator=(const McsLock&) = delete;
+
+    void lock() {
+        Node* node = acquireNode();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->locked.store(true, std::memory_order_relaxed);
+        Node* pred = tail_.exchange(node, std::memory_order_acq_rel);
+        if (pred != nullptr) {
+            pred->next.store(node, std::memory_order_release);
+            std::uint32_t spins = 0;
+            while (node->locked.load(std::memory_order_acquire)) {
+                detail::spinPause(spins);  // Spinning on our own node: no traffic until the hand-off
+            }
+        }
+        holder_ = node;  // Only the holder reads or writes this
+    }
+
+    bool try_lock() {
+        Node* node = acquireNode();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* expected = nullptr;
+        if (!tail_.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            releaseNode(node);
+            return false;
+        }
+        holder_ = node;
+        return true;
+    }
+
+    void unlock() {
+        Node* node = holder_;
+        Node* next = node->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            Node* expected = node;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                releaseNode(node);
+                return;  // Nobody waiting
+            }
+            // A successor swapped itself into tail_ but has not linked itself to us yet
+            std::uint32_t spins = 0;
+            while ((next = node->next.load(std::memory_order_acquire)) == nullptr) {
+                detail::spinPause(spins);
+            }
+        }
+        next->locked.store(false, std::memory_order_release);
+        releaseNode(node);
+    }
+
+private:
+    // Padded rather than alignas(64): C++11 operator new ignores over-alignment. Two nodes are then at least
+    // 64 bytes apart, so no two waiters' flags share a cache line.
+    struct Node {
+        std::atomic<Node*> next;
+        std::atomic<bool> locked;
+        char pad[64];
+    };
+
+    // Queue nodes come from a per-thread free list, so a thread can hold several MCS locks at once. A node is
+    // free again as soon as unlock() returns: nobody else refers to it after the hand-off.
+    struct NodePool {
+        std::vector<std::unique_ptr<Node>> all;
+        std::vector<Node*> free;
+    };
+
+    static NodePool& nodePool() {
+        static thread_local NodePool pool;
+        return pool;
+    }
+
+    static Node* acquireNode() {
+        NodePool& pool = nodePool();
+        if (pool.free.empty()) {
+            pool.all.emplace_back(new Node);
+            return pool.all.back().get();
+        }
+        Node* node = pool.free.back();
+        pool.free.pop_back();
+        return node;
+    }
+
+    static void releaseNode(Node* node) { nodePool().free.push_back(node); }
+
+    alignas(64) std::atomic<Node*> tail_;
+    Node* holder_;
+};
+
+class AdaptiveSpinMutex {
+public:
+    AdaptiveSpinMutex() : state_(kUnlocked) {}
+    AdaptiveSpinMutex(const AdaptiveSpinMutex&) = delete;
+    AdaptiveSpinMutex& operator=(const AdaptiveSpinMutex&) = delete;
+
+    void lock() {
+        // Spin phase: test-and-test-and-set with exponential backoff
+        int backoff = 1;
+        for (int round = 0; round < kSpinRounds; ++round) {
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if (s == kUnlocked && state_.compare_exchange_weak(s, kLocked, std::memory_order_acquire)) {
+                return;
+            }
+            for (int i = 0; i < backoff; ++i) {
+                futex::detail::cpuRelax();
+            }
+            backoff = backoff < kMaxBackoff ? backoff * 2 : backoff;
+        }
+        // Park phase: mark the lock contended so unlock() knows to wake somebody, then sleep
+        while (state_.exchange(kContended, std::memory_order_acquire) != kUnlocked) {
+            futex::detail::wait(state_, kContended);
+        }
+    }
+
+    bool try_lock() {
+        std::uint32_t expected = kUnlocked;
+        return state_.compare_exchange_strong(expected, kLocked, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() {
+        if (state_.exchange(kUnlocked, std::memory_order_release) == kContended) {
+            futex::detail::wakeOne(state_);
+        }
+    }
+
+private:
+    static const std::uint32_t kUnlocked = 0;
+    static const std::uint32_t kLocked = 1;
+    static const std::uint32_t kContended = 2;  // Locked, and somebody may be asleep
+    static const int kSpinRounds = 10;           // Backoff 1, 2, 4 ... 256 pauses: a few microseconds in total
+    static const int kMaxBackoff = 256;
+
+    std::atomic<std::uint32_t> state_;
+};
+
+}  // namespace locks
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "spsc_ring.h"
+
+/*
+mutex.cpp protects shared data with a lock that any number of threads may contend for. In a pipeline, though, most
+queues connect exactly one stage to the next: one producer, one consumer. SpscRing from spsc_ring.h is built for
+that case: no lock, no CAS, and with cached indices most operations do not touch a cache line the other core owns.
+The benchmark pins the two threads to different cores (when there are at least two) and measures
+- throughput in items per second, pushing and popping one item at a time and in batches of 32, and
+- latency as half the round-trip time of a ping-pong between two rings, reported as p50/p99/p99.9.
+*/
+
+// -std=c++11 -O2 -pthread, Linux only (thread pinning)
+
+using Clock = std::chrono::steady_clock;
+
+void pinToCore(unsigned core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % std::max(1u, std::thread::hardware_concurrency()), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+double throughput(std::size_t batch, std::uint64_t items, unsigned producerCore, unsigned consumerCore) {
+    SpscRing<std::uint64_t> ring(4096);
+    std::uint64_t checksum = 0;
+    auto start = Clock::now();
+    std::thread consumer([&] {
+        pinToCore(consumerCore);
+        std::vector<std::uint64_t> buffer(batch);
+        for (std::uint64_t received = 0; received < items;) {
+            std::size_t n = ring.tryPopBulk(buffer.begin(), batch);
+            if (n == 0) {
+                std::this_thread::yield();  // Only matters when both threads share a core
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                checksum += buffer[i];
+            }
+            received += n;
+        }
+    });
+    std::thread producer([&] {
+        pinToCore(producerCore);
+        std::vector<std::uint64_t> buffer(batch);
+        for (std::uint64_t sent = 0; sent < items;) {
+            std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(batch, items - sent));
+            for (std::size_t i = 0; i < want; ++i) {
+                buffer[i] = sent + i;
+            }
+            std::size_t n = ring.tryPushBulk(buffer.begin(), want);  // A partial push is fine: the rest is rebuilt
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            sent += n;
+        }
+    });
+    producer.join();
+    consumer.join();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (checksum != items * (items - 1) / 2) {
+        std::cout << "checksum mismatch!\n";
+    }
+    return items / elapsed.count();
+}
+
+// One-way latency estimated as half of a ping-pong round trip; returns sorted samples in nanoseconds
+std::vector<double> pingPong(int rounds, unsigned pingCore, unsigned pongCore) {
+    SpscRing<std::uint64_t> ping(64), pong(64);
+    std::thread echo([&] {
+        pinToCore(pongCore);
+        std::uint64_t value;
+        for (int i = 0; i < rounds; ++i) {
+            while (!ping.tryPop(value)) {
+            }
+            while (!pong.tryPush(value)) {
+            }
+        }
+    });
+    pinToCore(pingCore);
+    std::vector<double> samples;
+    samples.reserve(rounds);
+    std::uint64_t value;
+    for (int i = 0; i < rounds; ++i) {
+        auto sent = Clock::now();
+        while (!ping.tryPush(static_cast<std::uint64_t>(i))) {
+        }
+        while (!pong.tryPop(value)) {
+        }
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - sent).count() / 2);
+    }
+    echo.join();
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+int main() {
+    // Example 1: A two-stage pipeline - the parser hands records to the writer
+    {
+        SpscRing<int> ring(8);
+        std::thread stage2([&] {
+            int sum = 0, value;
+            for (int received = 0; received < 100;) {
+                if (ring.tryPop(value)) {
+                    sum += value;
+                    ++received;
+                } else {
+                    std::this_thread::yield();  // Empty: stage 1 is behind
+                }
+            }
+            std::cout << "Stage 2 received 100 items, sum " << sum << "\n";
+        });
+        for (int i = 1; i <= 100; ++i) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();  // Full: stage 2 is behind
+            }
+        }
+        stage2.join();
+    }
+
+    // Example 2: Throughput and latency with the threads on different cores
+    unsigned cores = std::thread::hardware_concurrency();
+    unsigned producerCore = 0, consumerCore = cores > 1 ? 1 : 0;
+    if (cores < 2) {
+        std::cout << "Only one core available: both threads share it, so the numbers measure time slicing\n";
+    } else {
+        std::cout << "Producer on core " << producerCore << ", consumer on core " << consumerCore << "\n";
+    }
+    for (std::size_t batch : {std::size_t(1), std::size_t(32)}) {
+        double rate = throughput(batch, 50000000, producerCore, consumerCore);
+        std::printf("batch %2zu: %7.1f M items/s\n", batch, rate / 1e6);
+    }
+    if (cores > 1) {  // Spinning ping-pong on one core only measures scheduler time slices
+        std::vector<double> l = pingPong(200000, producerCore, consumerCore);
+        std::printf("latency: p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns\n", l[l.size() / 2], l[l.size() * 99 / 100],
+                    l[l.size() * 999 / 1000]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+SpscRing<T>: a bounded queue for exactly one producer thread and one consumer thread.
+- Wait-free: with a single thread on each side nothing has to be claimed, so there are no CAS loops. The producer
+  owns tail, the consumer owns head, and each side only reads the other's index.
+- Cached indices: reading the other side's index is what moves cache lines between the two cores. The producer
+  keeps a private copy of head and re-reads the shared one only when the copy says the ring is full (the consumer
+  does the same with tail), so in steady state most operations touch no shared line except the slot itself.
+- Batch commit: tryPushBulk / tryPopBulk move several items and then publish the new index once, instead of once per
+  item, so the other side sees one cache-line transfer per batch.
+- Capacity is rounded up to a power of two so positions wrap with a mask instead of a division.
+Using one SpscRing from more than one producer or more than one consumer thread is undefined.
+*/
+
+// -std=c++11
+
+template <class T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask_ = size - 1;
+        slots_.reset(new Storage[size]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() {
+        std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        for (std::size_t pos = consumer_.head.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            slot(pos)->~T();
+        }
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Producer side
+    bool tryPush(T value) { return tryPushBulk(&value, 1) == 1; }
+
+    // Pushes up to n items from first and publishes them together; returns how many fit
+    template <class InputIt>
+    std::size_t tryPushBulk(InputIt first, std::size_t n) {
+        std::size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        std::size_t free = capacity() - (tail - producer_.cachedHead);
+        if (free < n) {
+            producer_.cachedHead = consumer_.head.load(std::memory_order_acquire);
+            free = capacity() - (tail - producer_.cachedHead);
+        }
+        std::size_t count = n < free ? n : free;
+        for (std::size_t i = 0; i < count; ++i, ++first) {
+            new (slot(tail + i)) T(std::move(*first));
+        }
+        if (count > 0) {
+            producer_.tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Consumer side
+    bool tryPop(T& out) { return tryPopBulk(&out, 1) == 1; }
+
+    // Pops up to n items into out and releases their slots together; returns how many were available
+    template <class OutputIt>
+    std::size_t tryPopBulk(OutputIt out, std::size_t n) {
+        std::size_t head = consumer_.head.load(std::memory_order_relaxed);
+        std::size_t available = consumer_.cachedTail - head;
+        if (available < n) {
+            consumer_.cachedTail = producer_.tail.load(std::memory_order_acquire);
+            available = consumer_.cachedTail - head;
+        }
+        std::size_t count = n < available ? n : available;
+        for (std::size_t i = 0; i < count; ++i) {
+            T* value = slot(head + i);
+            *out++ = std::move(*value);
+            value->~T();
+        }
+        if (count > 0) {
+            consumer_.head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+    static const std::size_t kCacheLine = 64;
+
+    // Everything the producer writes on one line, everything the consumer writes on another
+    struct alignas(kCacheLine) ProducerSide {
+        std::atomic<std::size_t> tail{0};
+        std::size_t cachedHead = 0;
+    };
+    struct alignas(kCacheLine) ConsumerSide {
+        std::atomic<std::size_t> head{0};
+        std::size_t cachedTail = 0;
+    };
+
+    T* slot(std::size_t pos) { return reinterpret_cast<T*>(&slots_[pos & mask_]); }
+
+    ProducerSide producer_;
+    ConsumerSide consumer_;
+    std::size_t mask_ = 0;
+    std::unique_ptr<Storage[]> slots_;
+};
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "distributed_shared_mutex.h"
+
+/*
+SharedData from "shared_time_mutex and shared_lock.cpp" with DistributedSharedMutex from distributed_shared_mutex.h
+in place of std::shared_timed_mutex. The locking code stays the same: std::shared_lock for readers, std::unique_lock
+for writers.
+The benchmark adds reader threads one power of two at a time, up to the number of cores, while one writer updates the
+data every millisecond, and reports reads per second for both mutexes.
+*/
+
+// -std=c++14 -O2 -pthread, Linux
+
+template <class Mutex>
+class SharedData {
+public:
+    int readData() const {
+        std::shared_lock<Mutex> lock(mutex_);  // Acquires a shared lock for reading
+        int sum = 0;
+        for (int v : data_) {
+            sum += v;
+        }
+        return sum;
+    }
+
+    void writeData(int value) {
+        std::unique_lock<Mutex> lock(mutex_);  // Acquires a unique lock for writing
+        std::fill(std::begin(data_), std::end(data_), value);
+    }
+
+private:
+    mutable Mutex mutex_;
+    int data_[16] = {};
+};
+
+// Million reads per second over all readers
+template <class Mutex>
+double readRate(int readers, std::chrono::milliseconds duration) {
+    SharedData<Mutex> data;
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<int> badSums{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            std::uint64_t local = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (data.readData() % 16 != 0) {  // All 16 values are always equal
+                    ++badSums;
+                }
+                ++local;
+            }
+            reads += local;
+        });
+    }
+    std::thread writer([&] {
+        for (int value = 1; !stop.load(std::memory_order_relaxed); ++value) {
+            data.writeData(value);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    writer.join();
+    if (badSums != 0) {
+        std::cout << "Inconsistent reads: " << badSums << "\n";
+    }
+    return reads / std::chrono::duration<double>(duration).count() / 1e6;
+}
+
+int main() {
+    // Example 1: The original SharedData with the distributed lock
+    {
+        SharedData<DistributedSharedMutex> sharedData;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 5; ++i) {
+            threads.emplace_back([&] { sharedData.readData(); });
+        }
+        std::thread writerThread([&] { sharedData.writeData(42); });
+        for (auto& t : threads) {
+            t.join();
+        }
+        writerThread.join();
+        std::cout << "Sum after the write: " << sharedData.readData() << " (expected " << 42 * 16 << ")\n";
+    }
+
+    // Example 2: Read throughput from 1 to N reader threads
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> readerCounts;
+    for (int r = 1; r < cores; r *= 2) {
+        readerCounts.push_back(r);
+    }
+    readerCounts.push_back(cores);
+    if (cores < 4) {
+        readerCounts = {1, 2, 4};  // A single core cannot show scaling, but the run still compares the fast paths
+    }
+    std::printf("\nreaders   shared_timed_mutex M reads/s   DistributedSharedMutex M reads/s   speedup\n");
+    for (int readers : readerCounts) {
+        double plain = readRate<std::shared_timed_mutex>(readers, std::chrono::milliseconds(300));
+        double distributed = readRate<DistributedSharedMutex>(readers, std::chrono::milliseconds(300));
+        std::printf("%7d %32.2f %34.2f %8.2fx\n", readers, plain, distributed, distributed / plain);
+    }
+
+    return 0;
+}
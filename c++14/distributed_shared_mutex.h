@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <sched.h>
+
+/*
+A reader-writer lock whose read side scales with the number of cores. std::shared_timed_mutex keeps one reader count
+that every lock_shared() and unlock_shared() modifies, so with readers on many cores that counter's cache line is
+always somewhere else. DistributedSharedMutex keeps one reader count per CPU instead, each on its own cache line:
+- A reader increments the count of the CPU it first ran on and then checks that no writer is active. With no writer
+  around, it touches only its own cache line (which stays in its core's cache) and one line that is only ever read.
+- A writer raises a flag, so new readers step back, and then waits until every per-CPU count is zero.
+So reads get much cheaper and writes much more expensive (a scan of every slot) - the right trade for read-mostly
+data such as configuration. A waiting writer has priority over new readers, so readers cannot starve writers.
+It has the members std::shared_lock and std::unique_lock need: lock_shared/try_lock_shared/unlock_shared and
+lock/try_lock/unlock.
+*/
+
+// -std=c++14 -pthread, Linux (sched_getcpu)
+
+class DistributedSharedMutex {
+public:
+    static constexpr unsigned kMaxSlots = 64;
+
+    DistributedSharedMutex() : slotMask_(slotCount() - 1), writer_(false), sleepers_(0) {}
+    DistributedSharedMutex(const DistributedSharedMutex&) = delete;
+    DistributedSharedMutex& operator=(const DistributedSharedMutex&) = delete;
+
+    void lock_shared() {
+        std::atomic<std::uint32_t>& readers = slots_[threadSlot() & slotMask_].readers;
+        while (true) {
+            // seq_cst on both sides (Dekker): either we see the writer's flag or the writer sees our count
+            readers.fetch_add(1);
+            if (!writer_.load()) {
+                return;
+            }
+            readers.fetch_sub(1, std::memory_order_release);  // Step back while a writer is active
+            waitForWriter();
+        }
+    }
+
+    bool try_lock_shared() {
+        std::atomic<std::uint32_t>& readers = slots_[threadSlot() & slotMask_].readers;
+        readers.fetch_add(1);
+        if (!writer_.load()) {
+            return true;
+        }
+        readers.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void unlock_shared() {
+        slots_[threadSlot() & slotMask_].readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void lock() {
+        writerMutex_.lock();  // One writer at a time
+        writer_.store(true);
+        for (unsigned i = 0; i <= slotMask_; ++i) {
+            // seq_cst, like the flag store: an acquire load could be ordered before the store (e.g. stlr + ldapr on
+            // ARM) and miss a reader that has already seen writer_ == false
+            for (int spins = 0; slots_[i].readers.load() != 0; ++spins) {
+                if (spins >= kSpinLimit) {
+                    std::this_thread::yield();  // Readers hold the lock briefly; no need to sleep for them
+                }
+            }
+        }
+    }
+
+    bool try_lock() {
+        if (!writerMutex_.try_lock()) {
+            return false;
+        }
+        writer_.store(true);
+        for (unsigned i = 0; i <= slotMask_; ++i) {
+            if (slots_[i].readers.load() != 0) {  // seq_cst, as in lock()
+                unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() {
+        writer_.store(false);
+        if (sleepers_.load() != 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex_);  // Pairs with the re-check in waitForWriter()
+            wakeUp_.notify_all();
+        }
+        writerMutex_.unlock();
+    }
+
+private:
+    static constexpr int kSpinLimit = 200;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint32_t> readers{0};
+    };
+
+    static unsigned slotCount() {
+        unsigned cpus = std::thread::hardware_concurrency();
+        unsigned count = 1;
+        while (count < cpus && count < kMaxSlots) {
+            count *= 2;
+        }
+        return count;
+    }
+
+    // A thread keeps the slot of the CPU it first locked on, so unlock_shared() finds the count lock_shared()
+    // incremented even if the thread has migrated in between. Migration only costs speed, not correctness.
+    static unsigned threadSlot() {
+        static std::atomic<unsigned> nextSlot{0};
+        static thread_local unsigned slot = [] {
+            int cpu = sched_getcpu();
+            return cpu >= 0 ? static_cast<unsigned>(cpu) : nextSlot.fetch_add(1, std::memory_order_relaxed);
+        }();
+        return slot;
+    }
+
+    void waitForWriter() {
+        for (int spins = 0; spins < kSpinLimit; ++spins) {
+            if (!writer_.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1);
+        wakeUp_.wait(lock, [this] { return !writer_.load(); });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Slot slots_[kMaxSlots];
+    const unsigned slotMask_;
+    alignas(64) std::atomic<bool> writer_;  // Read by every reader, written only by writers
+    std::atomic<int> sleepers_;
+    std::mutex writerMutex_;
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+};
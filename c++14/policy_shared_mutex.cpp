@@ -0,0 +1,137 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "policy_shared_mutex.h"
+
+/*
+In "shared_time_mutex and shared_lock.cpp" five readers are started before the writer. With only five short reads
+the writer gets its turn soon enough; with readers that keep coming it may not. PolicySharedMutex from
+policy_shared_mutex.h lets the program choose who goes first, and its try_lock_for() gives up at a deadline instead
+of waiting forever.
+The benchmark keeps several readers reading back to back and lets a writer ask for the lock every 200 microseconds
+with a 20 ms deadline. It reports how long the writer waited (p50/p99/p99.9, timeouts counted at the deadline), how
+many write attempts timed out and how many reads got through.
+*/
+
+// -std=c++14 -O2 -pthread
+
+using Clock = std::chrono::steady_clock;
+
+template <class Mutex>
+class SharedData {
+public:
+    template <class... Args>
+    explicit SharedData(Args... args) : mutex_(args...) {}
+
+    int readData() const {
+        std::shared_lock<Mutex> lock(mutex_);  // Acquires a shared lock for reading
+        int sum = 0;
+        for (int i = 0; i < 200; ++i) {  // Simulate a short read
+            sum += data_[i % 16];
+        }
+        return sum;
+    }
+
+    // Gives up if the lock is not ours by the deadline
+    bool writeData(int value, std::chrono::milliseconds timeout) {
+        std::unique_lock<Mutex> lock(mutex_, timeout);  // Timed constructor: calls try_lock_for
+        if (!lock.owns_lock()) {
+            return false;
+        }
+        std::fill(std::begin(data_), std::end(data_), value);
+        return true;
+    }
+
+private:
+    mutable Mutex mutex_;
+    int data_[16] = {};
+};
+
+struct Latency {
+    double p50, p99, p999;  // Microseconds
+    int timeouts;
+    double readsPerSecond;
+};
+
+template <class Mutex, class... Args>
+Latency writerLatency(int readers, std::chrono::milliseconds duration, Args... args) {
+    const std::chrono::milliseconds timeout(20);
+    SharedData<Mutex> data(args...);
+    std::atomic<bool> stop{false};
+    std::atomic<long> reads{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            long local = 0, sink = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sink += data.readData();
+                ++local;
+            }
+            reads += local + (sink == -1);  // Keep the reads from being optimized away
+        });
+    }
+    std::vector<double> waits;
+    int timeouts = 0;
+    auto end = Clock::now() + duration;
+    for (int value = 1; Clock::now() < end; ++value) {
+        auto start = Clock::now();
+        if (!data.writeData(value, timeout)) {
+            ++timeouts;
+        }
+        waits.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::sort(waits.begin(), waits.end());
+    auto percentile = [&](double p) { return waits[static_cast<size_t>(p * (waits.size() - 1))]; };
+    return {percentile(0.5), percentile(0.99), percentile(0.999), timeouts,
+            reads / std::chrono::duration<double>(duration).count()};
+}
+
+void printRow(const char* name, const Latency& l) {
+    std::printf("%-20s %10.1f %10.1f %10.1f %9d %12.2f\n", name, l.p50, l.p99, l.p999, l.timeouts,
+                l.readsPerSecond / 1e6);
+}
+
+int main() {
+    // Example 1: The original scenario - five readers first, then a writer - with phase-fair locking
+    {
+        SharedData<PolicySharedMutex> sharedData(SharedMutexPolicy::PhaseFair);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 5; ++i) {
+            threads.emplace_back([&] { sharedData.readData(); });
+        }
+        std::thread writerThread([&] {
+            bool written = sharedData.writeData(42, std::chrono::milliseconds(100));
+            std::cout << "Writer " << (written ? "wrote 42" : "gave up after 100 ms") << std::endl;
+        });
+        for (auto& t : threads) {
+            t.join();
+        }
+        writerThread.join();
+    }
+
+    // Example 2: Writer wait times under heavy read traffic
+    const int readers = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::chrono::milliseconds duration(1000);
+    std::printf("\n%d readers, writer every 200 us with a 20 ms deadline\n", readers);
+    std::printf("%-20s %10s %10s %10s %9s %12s\n", "mutex", "p50 us", "p99 us", "p99.9 us", "timeouts", "M reads/s");
+    printRow("shared_timed_mutex", writerLatency<std::shared_timed_mutex>(readers, duration));
+    printRow("ReaderPreferring",
+             writerLatency<PolicySharedMutex>(readers, duration, SharedMutexPolicy::ReaderPreferring));
+    printRow("WriterPreferring",
+             writerLatency<PolicySharedMutex>(readers, duration, SharedMutexPolicy::WriterPreferring));
+    printRow("PhaseFair", writerLatency<PolicySharedMutex>(readers, duration, SharedMutexPolicy::PhaseFair));
+
+    return 0;
+}
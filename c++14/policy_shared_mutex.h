@@ -0,0 +1,173 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/*
+std::shared_timed_mutex does not say who goes first when readers and a writer are both waiting, and with a steady
+stream of overlapping readers a writer may never find the reader count at zero. PolicySharedMutex makes that choice
+explicit:
+- ReaderPreferring: a reader gets in whenever no writer holds the lock. Best read throughput, but writers can starve.
+- WriterPreferring: once a writer is waiting, new readers queue behind it. Writers get in quickly; readers can starve
+  if writes never stop.
+- PhaseFair: reads and writes alternate in phases. A waiting writer stops new readers, but when a writer releases
+  the lock, the readers that were already waiting go next, before the next writer. Neither side can starve, and a
+  writer waits for at most one read phase and one write phase.
+Like std::shared_timed_mutex it has timed versions of both lock kinds (try_lock_for/_until and
+try_lock_shared_for/_until) that give up at a deadline, so std::unique_lock and std::shared_lock work with it,
+including their timed constructors.
+*/
+
+// -std=c++14 -pthread
+
+enum class SharedMutexPolicy { ReaderPreferring, WriterPreferring, PhaseFair };
+
+class PolicySharedMutex {
+public:
+    explicit PolicySharedMutex(SharedMutexPolicy policy = SharedMutexPolicy::PhaseFair) : policy_(policy) {}
+    PolicySharedMutex(const PolicySharedMutex&) = delete;
+    PolicySharedMutex& operator=(const PolicySharedMutex&) = delete;
+
+    SharedMutexPolicy policy() const { return policy_; }
+
+    // Exclusive (writer) side
+
+    void lock() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waitingWriters_;
+        writersCv_.wait(lock, [this] { return writerMayEnter(); });
+        --waitingWriters_;
+        writer_ = true;
+    }
+
+    bool try_lock() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!writerMayEnter()) {
+            return false;
+        }
+        writer_ = true;
+        return true;
+    }
+
+    template <class Rep, class Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waitingWriters_;
+        bool acquired = writersCv_.wait_until(lock, deadline, [this] { return writerMayEnter(); });
+        --waitingWriters_;
+        if (acquired) {
+            writer_ = true;
+        } else if (waitingWriters_ == 0) {
+            readersCv_.notify_all();  // Readers may have been held back only because of us
+        }
+        return acquired;
+    }
+
+    void unlock() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_ = false;
+        if (policy_ == SharedMutexPolicy::PhaseFair) {
+            readerTurn_ = waitingReaders_;  // Everybody who queued during this write phase reads next
+        }
+        wakeWaiters();
+    }
+
+    // Shared (reader) side
+
+    void lock_shared() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waitingReaders_;
+        readersCv_.wait(lock, [this] { return readerMayEnter(); });
+        --waitingReaders_;
+        enterShared();
+    }
+
+    bool try_lock_shared() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!readerMayEnter()) {
+            return false;
+        }
+        enterShared();
+        return true;
+    }
+
+    template <class Rep, class Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waitingReaders_;
+        bool acquired = readersCv_.wait_until(lock, deadline, [this] { return readerMayEnter(); });
+        --waitingReaders_;
+        if (acquired) {
+            enterShared();
+        } else if (readerTurn_ > waitingReaders_) {
+            // We had a turn in the coming read phase; don't let the writers wait for it
+            readerTurn_ = waitingReaders_;
+            wakeWaiters();
+        }
+        return acquired;
+    }
+
+    void unlock_shared() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--readers_ == 0 && waitingWriters_ != 0) {
+            writersCv_.notify_all();
+        }
+    }
+
+private:
+    bool readerMayEnter() const {
+        if (writer_) {
+            return false;
+        }
+        switch (policy_) {
+        case SharedMutexPolicy::ReaderPreferring:
+            return true;
+        case SharedMutexPolicy::WriterPreferring:
+            return waitingWriters_ == 0;
+        case SharedMutexPolicy::PhaseFair:
+            return waitingWriters_ == 0 || readerTurn_ > 0;
+        }
+        return false;
+    }
+
+    bool writerMayEnter() const {
+        return !writer_ && readers_ == 0 && readerTurn_ == 0;
+    }
+
+    void enterShared() {
+        ++readers_;
+        if (readerTurn_ > 0 && --readerTurn_ == 0 && waitingWriters_ != 0) {
+            writersCv_.notify_all();  // The read phase is complete; the writers are next once it drains
+        }
+    }
+
+    void wakeWaiters() {
+        if (waitingReaders_ != 0) {
+            readersCv_.notify_all();
+        }
+        if (waitingWriters_ != 0) {
+            writersCv_.notify_all();
+        }
+    }
+
+    const SharedMutexPolicy policy_;
+    std::mutex mutex_;
+    std::condition_variable readersCv_;
+    std::condition_variable writersCv_;
+    int readers_ = 0;          // Readers holding the lock
+    bool writer_ = false;      // A writer holds the lock
+    int waitingReaders_ = 0;
+    int waitingWriters_ = 0;
+    int readerTurn_ = 0;       // PhaseFair: readers still entitled to enter before the next writer
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Two ways to let many threads read shared data without writing to any cache line that other readers also touch.
+A std::shared_lock does write one: every reader increments and decrements the reader count inside the mutex, so that
+line travels from core to core on every read even when nobody ever writes.
+- SeqLock<T>: the writer bumps a sequence number to an odd value, writes the data and bumps it back to even. A reader
+  reads the sequence number, copies the data and reads the sequence number again; if it changed (or was odd), a
+  write got in the way and the reader simply retries. Readers only load, so they never slow each other down - but a
+  reader may copy a half-written value before it notices, which is why T must be trivially copyable. The data is kept
+  in relaxed atomic words, so those racing copies are well-defined.
+- RcuCell<T> (read-copy-update): the data lives behind an atomic pointer. A writer copies the current object, changes
+  the copy and swaps the pointer; readers use whichever object the pointer showed when they started. The old object
+  can only be deleted once no reader can still be using it. Every thread announces the epoch in which it started
+  reading in a slot of its own (RcuDomain), and a retired object is freed once every slot is idle or has moved past
+  the epoch in which the object was replaced. Works for any T, e.g. strings, vectors, maps.
+Both serialize writers with a std::mutex and are meant for read-mostly data: SeqLock readers retry as long as writes
+keep coming, and every RcuCell write copies the whole object.
+*/
+
+// -std=c++14 -pthread
+
+namespace readmostly {
+
+template <class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T byte-wise while it may be written");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+    explicit SeqLock(const T& value) : seq_(0) { storeWords(value); }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const {
+        std::array<std::uint64_t, kWords> copy;
+        while (true) {
+            std::uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();  // A writer is in the middle of an update
+                continue;
+            }
+            for (std::size_t i = 0; i < kWords; ++i) {
+                copy[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);  // The copy happens before the second check
+            if (seq_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(&value, copy.data(), sizeof(T));
+        return value;
+    }
+
+    void store(const T& value) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        write(value);
+    }
+
+    // Read-modify-write: f receives the current value by reference
+    template <class F>
+    void update(F f) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        T value = load();
+        f(value);
+        write(value);
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    void write(const T& value) {
+        std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);       // Odd: readers back off
+        std::atomic_thread_fence(std::memory_order_release);  // ... and see the odd value before any new data
+        storeWords(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    void storeWords(const T& value) {
+        std::array<std::uint64_t, kWords> copy{};
+        std::memcpy(copy.data(), &value, sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(copy[i], std::memory_order_relaxed);
+        }
+    }
+
+    alignas(64) std::atomic<std::uint64_t> seq_;
+    std::atomic<std::uint64_t> words_[kWords];
+    std::mutex writeMutex_;
+};
+
+// Process-wide bookkeeping of which threads are reading and since which epoch
+class RcuDomain {
+public:
+    static constexpr int kMaxThreads = 128;
+
+private:
+    struct Reader;
+
+public:
+    static RcuDomain& instance() {
+        static RcuDomain domain;
+        return domain;
+    }
+
+    // Read-side critical section. Nests; only the outermost guard touches the thread's slot.
+    class ReadGuard {
+    public:
+        ReadGuard() : reader_(RcuDomain::instance().currentReader()) {
+            if (reader_.depth++ == 0) {
+                // seq_cst store: the announcement must be visible to writers before we load the protected pointer.
+                // Acquire load: seeing a new epoch implies seeing every pointer swap made before it.
+                reader_.slot->epoch.store(RcuDomain::instance().epoch_.load(std::memory_order_acquire));
+            }
+        }
+        ~ReadGuard() {
+            if (--reader_.depth == 0) {
+                reader_.slot->epoch.store(kIdle, std::memory_order_release);
+            }
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        Reader& reader_;
+    };
+
+    // Starts a new epoch and returns the old one: readers that began after this call cannot see what was unlinked
+    // before it
+    std::uint64_t advance() { return epoch_.fetch_add(1); }
+
+    // Oldest epoch any thread is currently reading in; objects retired in an earlier epoch are unreachable
+    std::uint64_t oldestReader() const {
+        std::uint64_t oldest = UINT64_MAX;
+        for (const Slot& slot : slots_) {
+            std::uint64_t epoch = slot.epoch.load();
+            if (epoch != kIdle && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+private:
+    static constexpr std::uint64_t kIdle = 0;
+
+    struct alignas(64) Slot {  // One cache line per thread: readers only ever write their own
+        std::atomic<std::uint64_t> epoch{kIdle};
+        std::atomic<bool> owned{false};
+    };
+
+    struct Reader {
+        Slot* slot = nullptr;
+        int depth = 0;
+        ~Reader() {
+            if (slot) {
+                slot->owned.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    RcuDomain() = default;
+
+    Reader& currentReader() {
+        static thread_local Reader reader;
+        if (reader.slot == nullptr) {
+            reader.slot = claimSlot();
+        }
+        return reader;
+    }
+
+    Slot* claimSlot() {
+        for (Slot& slot : slots_) {
+            bool expected = false;
+            if (!slot.owned.load(std::memory_order_relaxed) &&
+                slot.owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &slot;
+            }
+        }
+        throw std::runtime_error("RcuDomain: more than kMaxThreads threads reading at once");
+    }
+
+    alignas(64) std::atomic<std::uint64_t> epoch_{1};
+    Slot slots_[kMaxThreads];
+};
+
+template <class T>
+class RcuCell {
+public:
+    RcuCell() : RcuCell(std::make_unique<T>()) {}
+    explicit RcuCell(std::unique_ptr<T> value) : current_(value.release()) {}
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // No reader may still be inside read() when the cell is destroyed
+    ~RcuCell() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // Calls f(const T&) on the current value and returns its result. The reference is valid only inside f.
+    template <class F>
+    auto read(F f) const -> decltype(f(std::declval<const T&>())) {
+        RcuDomain::ReadGuard guard;
+        return f(*current_.load());
+    }
+
+    void store(std::unique_ptr<T> value) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        publish(std::move(value));
+    }
+
+    // Copy, modify, swap: f receives a private copy of the current value by reference
+    template <class F>
+    void update(F f) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto copy = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+        f(*copy);
+        publish(std::move(copy));
+    }
+
+    // Blocks until every value replaced so far has been freed
+    void synchronize() {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        while (!reclaim()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::size_t pendingReclamation() const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return retired_.size();
+    }
+
+private:
+    void publish(std::unique_ptr<T> value) {
+        std::unique_ptr<T> old(current_.exchange(value.release()));
+        retired_.emplace_back(RcuDomain::instance().advance(), std::move(old));
+        reclaim();  // Deferred: whatever earlier writes left behind and no reader can see any more
+    }
+
+    // Frees every retired value no reader can still hold; returns true if none are left
+    bool reclaim() {
+        std::uint64_t oldest = RcuDomain::instance().oldestReader();
+        // Anything replaced in an epoch before the oldest reader's is unreachable
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                      [oldest](const Retired& entry) { return entry.first < oldest; }),
+                       retired_.end());
+        return retired_.empty();
+    }
+
+    std::atomic<T*> current_;
+    using Retired = std::pair<std::uint64_t, std::unique_ptr<T>>;  // (epoch it was replaced in, value)
+
+    std::vector<Retired> retired_;
+    mutable std::mutex writeMutex_;
+};
+
+}  // namespace readmostly
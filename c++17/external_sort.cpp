@@ -0,0 +1,344 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <memory>
+#include <type_traits>
+
+#include "work_stealing_pool.h"
+
+/*
+    The parallel sort examples assume the data fits in a std::vector. An external (out-of-core) merge sort handles
+    files far larger than RAM under a fixed memory budget:
+
+    1. **Run generation**: Read budget-sized chunks of the input, sort each one in memory with the parallel
+       ws::sort from work_stealing_pool.h, and spill it to a temporary run file.
+    2. **K-way merge**: Merge all runs at once through a min-heap holding the current head of every run. Every run
+       and the output get a large buffer carved out of the same budget, so the disk only sees big sequential reads
+       and writes instead of seeking between files for every element.
+    3. **Multi-pass**: If there are more runs than buffers that fit in the budget (each buffer is kept at least
+       kMinBufferBytes to stay sequential), groups of runs are merged into longer runs first.
+
+    Temporary files go to a private directory under std::filesystem::temp_directory_path() (or a directory passed
+    in) and are removed as soon as they have been merged. I/O failures throw std::runtime_error.
+*/
+
+// -std=c++17 -O2 -pthread
+// ./external_sort input.bin output.bin 1024   (sort a file of raw int32 values with a 1024 MiB budget)
+
+namespace external {
+
+constexpr std::size_t kMinBufferBytes = 4 << 20;  // 4 MiB: below this the merge starts to look like random I/O
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+inline File openFile(const std::filesystem::path& path, const char* mode) {
+    File f(std::fopen(path.string().c_str(), mode));
+    if (!f) {
+        throw std::runtime_error("cannot open " + path.string());
+    }
+    std::setvbuf(f.get(), nullptr, _IONBF, 0);  // We do our own (much larger) buffering
+    return f;
+}
+
+// Closes f and reports what fclose() reports: buffered data that could not be written shows up only here
+inline void closeFile(File& f) {
+    if (std::fclose(f.release()) != 0) {
+        throw std::runtime_error("close error (disk full?)");
+    }
+}
+
+template <class T>
+std::size_t readSome(std::FILE* f, T* data, std::size_t count) {
+    std::size_t got = std::fread(data, sizeof(T), count, f);
+    if (got < count && std::ferror(f)) {
+        throw std::runtime_error("read error");
+    }
+    return got;
+}
+
+template <class T>
+void writeAll(std::FILE* f, const T* data, std::size_t count) {
+    if (std::fwrite(data, sizeof(T), count, f) != count) {
+        throw std::runtime_error("write error (disk full?)");
+    }
+}
+
+// Buffered sequential reader over one run file
+template <class T>
+class RunReader {
+public:
+    RunReader(const std::filesystem::path& path, std::size_t bufferElems)
+        : file_(openFile(path, "rb")), buffer_(bufferElems) {
+        refill();
+    }
+
+    bool empty() const { return pos_ == size_; }
+    const T& front() const { return buffer_[pos_]; }
+
+    void pop() {
+        if (++pos_ == size_) {
+            refill();
+        }
+    }
+
+private:
+    void refill() {
+        size_ = readSome(file_.get(), buffer_.data(), buffer_.size());
+        pos_ = 0;
+    }
+
+    File file_;
+    std::vector<T> buffer_;
+    std::size_t pos_ = 0;
+    std::size_t size_ = 0;
+};
+
+// Buffered sequential writer
+template <class T>
+class RunWriter {
+public:
+    RunWriter(const std::filesystem::path& path, std::size_t bufferElems)
+        : file_(openFile(path, "wb")) {
+        buffer_.reserve(bufferElems);
+    }
+
+    ~RunWriter() {
+        if (file_ && !buffer_.empty()) {
+            std::fwrite(buffer_.data(), sizeof(T), buffer_.size(), file_.get());  // Best effort; close() reports errors
+        }
+    }
+
+    void push(const T& value) {
+        buffer_.push_back(value);
+        if (buffer_.size() == buffer_.capacity()) {
+            flush();
+        }
+    }
+
+    void close() {
+        flush();
+        closeFile(file_);
+    }
+
+private:
+    void flush() {
+        writeAll(file_.get(), buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    File file_;
+    std::vector<T> buffer_;
+};
+
+template <class T, class Compare>
+void mergeRuns(const std::vector<std::filesystem::path>& runs, const std::filesystem::path& output,
+               std::size_t memoryBytes, Compare comp) {
+    std::size_t bufferElems = std::max<std::size_t>(1, memoryBytes / (runs.size() + 1) / sizeof(T));
+
+    std::vector<RunReader<T>> readers;
+    readers.reserve(runs.size());
+    for (const auto& run : runs) {
+        readers.emplace_back(run, bufferElems);
+    }
+    RunWriter<T> writer(output, bufferElems);
+
+    // Min-heap of run indices ordered by each run's current head
+    auto greater = [&](std::size_t a, std::size_t b) { return comp(readers[b].front(), readers[a].front()); };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        if (!readers[i].empty()) {
+            heap.push(i);
+        }
+    }
+    while (!heap.empty()) {
+        std::size_t i = heap.top();
+        heap.pop();
+        writer.push(readers[i].front());
+        readers[i].pop();
+        if (!readers[i].empty()) {
+            heap.push(i);
+        }
+    }
+    writer.close();
+}
+
+struct Stats {
+    std::size_t elements = 0;
+    std::size_t runs = 0;
+    std::size_t mergePasses = 0;
+};
+
+// Sorts the raw array of T stored in input into output, using about memoryBytes of RAM
+template <class T, class Compare = std::less<>>
+Stats sortFile(const std::filesystem::path& input, const std::filesystem::path& output, std::size_t memoryBytes,
+               Compare comp = {}, std::filesystem::path tempDir = std::filesystem::temp_directory_path()) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are read and written as raw bytes");
+    namespace fs = std::filesystem;
+
+    // Private scratch directory, removed on every exit path
+    fs::path scratch = tempDir / ("external_sort_" + std::to_string(std::random_device{}()));
+    fs::create_directories(scratch);
+    struct Cleanup {
+        fs::path dir;
+        ~Cleanup() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+    } cleanup{scratch};
+
+    Stats stats;
+    std::vector<fs::path> runs;
+
+    // A file that is not a whole number of records is not a file of T: refuse it rather than drop the tail
+    if (std::uintmax_t bytes = fs::file_size(input); bytes % sizeof(T) != 0) {
+        throw std::runtime_error(input.string() + ": size " + std::to_string(bytes) + " is not a multiple of the " +
+                                 std::to_string(sizeof(T)) + "-byte record size");
+    }
+
+    // Phase 1: sorted runs. ws::sort needs a scratch buffer as large as the run, so a run is half the budget.
+    {
+        std::vector<T> run(std::max<std::size_t>(1, memoryBytes / 2 / sizeof(T)));
+        File in = openFile(input, "rb");
+        while (std::size_t got = readSome(in.get(), run.data(), run.size())) {
+            ws::sort(ws::par, run.begin(), run.begin() + got, comp);
+            fs::path path = scratch / ("run_" + std::to_string(runs.size()));
+            File out = openFile(path, "wb");
+            writeAll(out.get(), run.data(), got);
+            closeFile(out);
+            runs.push_back(path);
+            stats.elements += got;
+        }
+    }
+    stats.runs = runs.size();
+
+    if (runs.empty()) {
+        File empty = openFile(output, "wb");  // Empty input gives an empty output
+        closeFile(empty);
+        return stats;
+    }
+
+    // Phase 2: merge passes until a single merge can produce the output
+    // One buffer per input run plus one for the output, each at least kMinBufferBytes - but never fewer than 2 runs
+    const std::size_t fanIn = std::max<std::size_t>(3, memoryBytes / kMinBufferBytes) - 1;
+    std::size_t generation = 0;
+    while (runs.size() > fanIn) {
+        std::vector<fs::path> merged;
+        for (std::size_t i = 0; i < runs.size(); i += fanIn) {
+            std::vector<fs::path> group(runs.begin() + i, runs.begin() + std::min(runs.size(), i + fanIn));
+            fs::path path = scratch / ("merge_" + std::to_string(generation) + "_" + std::to_string(merged.size()));
+            mergeRuns<T>(group, path, memoryBytes, comp);
+            for (const auto& p : group) {
+                fs::remove(p);
+            }
+            merged.push_back(path);
+        }
+        runs.swap(merged);
+        ++generation;
+        ++stats.mergePasses;
+    }
+    mergeRuns<T>(runs, output, memoryBytes, comp);
+    ++stats.mergePasses;
+    return stats;
+}
+
+}  // namespace external
+
+// Memory budget in MiB, as given on the command line
+std::size_t parseBudget(const std::string& text) {
+    std::size_t used = 0;
+    unsigned long long megabytes = 0;
+    try {
+        megabytes = std::stoull(text, &used);
+    } catch (const std::out_of_range&) {
+        throw std::out_of_range("too large");
+    } catch (const std::invalid_argument&) {
+        throw std::invalid_argument("not a positive whole number");
+    }
+    if (used != text.size() || text[0] == '-') {
+        throw std::invalid_argument("not a positive whole number");
+    }
+    if (megabytes == 0) {
+        throw std::invalid_argument("must be at least 1 MiB");
+    }
+    if (megabytes > (std::numeric_limits<std::size_t>::max() >> 20)) {
+        throw std::out_of_range("too large");
+    }
+    return static_cast<std::size_t>(megabytes) << 20;
+}
+
+int main(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    fs::path input, output;
+    std::size_t memoryBytes = 16 << 20;  // Tiny default budget so the demo exercises spilling and merging
+    bool demo = argc < 3;
+
+    if (demo) {
+        // Generate 20M random ints (80 MB) - five times the budget
+        input = fs::temp_directory_path() / "external_sort_input.bin";
+        output = fs::temp_directory_path() / "external_sort_output.bin";
+        std::vector<std::int32_t> chunk(1 << 20);
+        std::mt19937 rng{42};
+        external::File f = external::openFile(input, "wb");
+        for (int i = 0; i < 20; ++i) {
+            for (auto& x : chunk) {
+                x = static_cast<std::int32_t>(rng());
+            }
+            external::writeAll(f.get(), chunk.data(), chunk.size());
+        }
+        external::closeFile(f);
+    } else {
+        input = argv[1];
+        output = argv[2];
+        if (argc > 3) {
+            try {
+                memoryBytes = parseBudget(argv[3]);
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid memory budget '" << argv[3] << "': " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    external::Stats stats;
+    try {
+        stats = external::sortFile<std::int32_t>(input, output, memoryBytes);
+    } catch (const std::exception& e) {
+        std::cerr << "External sort failed: " << e.what() << "\n";
+        return 1;
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << "External sort of " << stats.elements << " elements took " << duration.count() << " seconds ("
+              << stats.runs << " runs, " << stats.mergePasses << " merge pass(es)).\n";
+
+    // Verify by streaming the output once
+    {
+        external::RunReader<std::int32_t> reader(output, 1 << 20);
+        std::size_t count = 0;
+        bool sorted = true;
+        std::int32_t previous = 0;
+        for (; !reader.empty(); reader.pop(), ++count) {
+            sorted = sorted && (count == 0 || previous <= reader.front());
+            previous = reader.front();
+        }
+        std::cout << "Output sorted: " << std::boolalpha << sorted << ", elements: " << count << "\n";
+    }
+
+    if (demo) {
+        fs::remove(input);
+        fs::remove(output);
+    }
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <execution>
+#include <numeric> // For std::iota
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "work_stealing_pool.h"
+
+/*
+    The parallel_algorithms example times a single sort of 1'000'000 ints with one clock sample and no warmup, so the
+    numbers swing from run to run. This benchmark measures the same algorithms properly:
+
+    1. **Sweep**: Sizes from 1K up to --max (4x steps, 1K..1G), element types int32/int64/double, and every policy:
+       seq, par, par_unseq and the TBB-free ws::par from work_stealing_pool.h.
+    2. **Warmup and repetitions**: Each configuration runs --warmup untimed iterations (page faults, thread pool
+       start-up, branch predictors), then enough timed repetitions to get a stable distribution. Small sizes get more
+       repetitions so every configuration costs roughly the same wall time.
+    3. **Statistics**: Median and p99 of the per-repetition times, and throughput in elements/s based on the median.
+    4. **Output**: A table on stdout, or CSV / JSON (--format csv|json, --out file) to track scaling across
+       compilers and machines.
+
+    Each sort repetition restores the same shuffled input before the clock starts, so only the sort is measured.
+*/
+
+// -std=c++17 -O2 -pthread (add -ltbb with libstdc++, otherwise par/par_unseq run sequentially)
+// ./parallel_algorithms_benchmark --max 16777216 --reps 15 --format csv --out results.csv
+
+struct Options {
+    std::size_t minSize = 1 << 10;
+    std::size_t maxSize = 1 << 24;   // Up to 1 << 30 (1G) when the machine has the memory for it
+    int minReps = 9;
+    int warmup = 2;
+    std::string format = "table";     // table | csv | json
+    std::string out;
+};
+
+struct Result {
+    std::string algorithm;
+    std::string type;
+    std::string policy;
+    std::size_t size;
+    int reps;
+    double medianSec;
+    double p99Sec;
+    double elementsPerSec;
+};
+
+// Nearest-rank percentile of an already sorted sample
+double percentile(const std::vector<double>& sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+    rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+// setup() runs untimed before every repetition, body() is the timed part
+template <class Setup, class Body>
+std::vector<double> measure(int warmup, int reps, Setup setup, Body body) {
+    for (int i = 0; i < warmup; ++i) {
+        setup();
+        body();
+    }
+    std::vector<double> samples;
+    samples.reserve(reps);
+    for (int i = 0; i < reps; ++i) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+// Runs fn(policyName, policy) once for every policy under test
+template <class Fn>
+void forEachPolicy(Fn&& fn) {
+    fn("seq", std::execution::seq);
+    fn("par", std::execution::par);
+    fn("par_unseq", std::execution::par_unseq);
+    fn("ws::par", ws::par);
+}
+
+// ws::par has its own algorithm overloads; everything else goes through std::
+template <class Policy, class It>
+void sortWith(const Policy& policy, It first, It last) {
+    if constexpr (std::is_same_v<Policy, ws::ParallelPolicy>) {
+        ws::sort(policy, first, last);
+    } else {
+        std::sort(policy, first, last);
+    }
+}
+
+template <class Policy, class It, class Out, class Op>
+void transformWith(const Policy& policy, It first, It last, Out out, Op op) {
+    if constexpr (std::is_same_v<Policy, ws::ParallelPolicy>) {
+        ws::transform(policy, first, last, out, op);
+    } else {
+        std::transform(policy, first, last, out, op);
+    }
+}
+
+// The transform of the parallel_algorithms example, x * 2. Integers are doubled in unsigned arithmetic: at the
+// largest sizes x * 2 no longer fits in an int32, and signed overflow would be undefined behavior.
+template <class T>
+T doubled(T x) {
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(static_cast<std::make_unsigned_t<T>>(x) * 2u);
+    } else {
+        return x * 2;
+    }
+}
+
+constexpr std::size_t kMaxSize = std::size_t{1} << 30;  // 1G elements
+constexpr int kMaxReps = 1000;
+
+template <class T>
+void benchmarkType(const Options& opt, const std::string& typeName, std::vector<Result>& results) {
+    for (std::size_t n = opt.minSize; n <= opt.maxSize; n *= 4) {
+        // Keep the amount of work per configuration roughly constant: ~4M elements, at least minReps samples
+        int reps = static_cast<int>(std::clamp<std::size_t>((std::size_t{1} << 22) / n, opt.minReps, kMaxReps));
+
+        std::vector<T> shuffled(n);
+        std::iota(shuffled.begin(), shuffled.end(), T(1));
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64{42});  // Fixed seed: same input every run
+        std::vector<T> data(n);
+        std::vector<T> output(n);
+
+        auto record = [&](const char* algorithm, const char* policy, std::vector<double> samples) {
+            double median = percentile(samples, 50);
+            results.push_back({algorithm, typeName, policy, n, reps, median, percentile(samples, 99),
+                               static_cast<double>(n) / median});
+        };
+
+        forEachPolicy([&](const char* name, const auto& policy) {
+            auto sortSamples = measure(opt.warmup, reps,
+                [&] { std::copy(shuffled.begin(), shuffled.end(), data.begin()); },
+                [&] { sortWith(policy, data.begin(), data.end()); });
+            record("sort", name, std::move(sortSamples));
+
+            auto transformSamples = measure(opt.warmup, reps, [] {},
+                [&] { transformWith(policy, shuffled.begin(), shuffled.end(), output.begin(), doubled<T>); });
+            record("transform", name, std::move(transformSamples));
+        });
+
+        if (n > opt.maxSize / 4) {
+            break;  // Avoid overflow of n *= 4 near SIZE_MAX
+        }
+    }
+}
+
+void writeTable(std::ostream& os, const std::vector<Result>& results) {
+    os << std::left << std::setw(11) << "algorithm" << std::setw(8) << "type" << std::setw(11) << "policy"
+       << std::setw(12) << "size" << std::setw(6) << "reps" << std::setw(14) << "median(s)" << std::setw(14)
+       << "p99(s)" << "elements/s\n";
+    for (const auto& r : results) {
+        os << std::left << std::setw(11) << r.algorithm << std::setw(8) << r.type << std::setw(11) << r.policy
+           << std::setw(12) << r.size << std::setw(6) << r.reps << std::scientific << std::setprecision(3)
+           << std::setw(14) << r.medianSec << std::setw(14) << r.p99Sec << r.elementsPerSec << std::defaultfloat
+           << "\n";
+    }
+}
+
+void writeCsv(std::ostream& os, const std::vector<Result>& results) {
+    os << "algorithm,type,policy,size,reps,median_s,p99_s,elements_per_s\n";
+    for (const auto& r : results) {
+        os << r.algorithm << ',' << r.type << ',' << r.policy << ',' << r.size << ',' << r.reps << ','
+           << r.medianSec << ',' << r.p99Sec << ',' << r.elementsPerSec << '\n';
+    }
+}
+
+void writeJson(std::ostream& os, const std::vector<Result>& results) {
+    os << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "  {\"algorithm\": \"" << r.algorithm << "\", \"type\": \"" << r.type << "\", \"policy\": \""
+           << r.policy << "\", \"size\": " << r.size << ", \"reps\": " << r.reps << ", \"median_s\": " << r.medianSec
+           << ", \"p99_s\": " << r.p99Sec << ", \"elements_per_s\": " << r.elementsPerSec << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "]\n";
+}
+
+
+void printUsage(std::ostream& os, const char* program) {
+    os << "Usage: " << program << " [--min N] [--max N] [--reps N] [--warmup N] [--format table|csv|json]"
+       << " [--out FILE]\n"
+       << "  --min, --max  smallest and largest element count (default 1024 and 16777216, at most " << kMaxSize
+       << ")\n"
+       << "  --reps        minimum timed repetitions per configuration (default 9, at most " << kMaxReps << ")\n"
+       << "  --warmup      untimed iterations before timing (default 2)\n"
+       << "  --format      output format (default table)\n"
+       << "  --out         write the results to FILE instead of stdout\n";
+}
+
+[[noreturn]] void usageError(const char* program, const std::string& message) {
+    std::cerr << program << ": " << message << "\n";
+    printUsage(std::cerr, program);
+    std::exit(1);
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--help" || key == "-h") {
+            printUsage(std::cout, argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 == argc) {
+            usageError(argv[0], "missing value for " + key);
+        }
+        std::string value = argv[++i];
+        try {
+            if (key == "--min") {
+                opt.minSize = std::stoull(value);
+            } else if (key == "--max") {
+                opt.maxSize = std::stoull(value);
+            } else if (key == "--reps") {
+                opt.minReps = std::stoi(value);
+            } else if (key == "--warmup") {
+                opt.warmup = std::stoi(value);
+            } else if (key == "--format") {
+                opt.format = value;
+            } else if (key == "--out") {
+                opt.out = value;
+            } else {
+                usageError(argv[0], "unknown option " + key);
+            }
+        } catch (const std::logic_error&) {  // std::invalid_argument or std::out_of_range from stoull/stoi
+            usageError(argv[0], "invalid value '" + value + "' for " + key);
+        }
+    }
+    if (opt.format != "table" && opt.format != "csv" && opt.format != "json") {
+        usageError(argv[0], "unknown format " + opt.format);
+    }
+    if (opt.maxSize > kMaxSize) {
+        usageError(argv[0], "--max must be at most " + std::to_string(kMaxSize));
+    }
+    opt.minSize = std::max<std::size_t>(opt.minSize, 1);
+    if (opt.minSize > opt.maxSize) {
+        usageError(argv[0], "--min must not exceed --max");
+    }
+    if (opt.minReps > kMaxReps) {
+        usageError(argv[0], "--reps must be at most " + std::to_string(kMaxReps));
+    }
+    opt.minReps = std::max(opt.minReps, 1);
+    opt.warmup = std::max(opt.warmup, 0);
+    return opt;
+}
+
+int main(int argc, char** argv) {
+    Options opt = parseOptions(argc, argv);
+
+    // Open the output before the sweep, so a bad path fails now rather than after minutes of benchmarking
+    std::ofstream file;
+    if (!opt.out.empty()) {
+        file.open(opt.out);
+        if (!file) {
+            std::cerr << argv[0] << ": cannot open " << opt.out << " for writing\n";
+            return 1;
+        }
+    }
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+
+    std::vector<Result> results;
+    benchmarkType<std::int32_t>(opt, "int32", results);
+    benchmarkType<std::int64_t>(opt, "int64", results);
+    benchmarkType<double>(opt, "double", results);
+
+    if (opt.format == "csv") {
+        writeCsv(os, results);
+    } else if (opt.format == "json") {
+        writeJson(os, results);
+    } else {
+        writeTable(os, results);
+    }
+    os.flush();
+    if (!os) {
+        std::cerr << argv[0] << ": error writing the results\n";
+        return 1;
+    }
+
+    return 0;
+}
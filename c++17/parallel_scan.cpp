@@ -0,0 +1,219 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <execution>
+#include <numeric> // For std::iota, std::inclusive_scan
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <unistd.h> // For sysconf
+
+#include "work_stealing_pool.h"
+
+/*
+    A prefix sum looks inherently sequential (out[i] depends on out[i - 1]), but with an associative operator it can
+    be split into independent blocks. The classic two-pass scheme is:
+
+    1. **Block reduce**: Every block computes the total of its elements in parallel.
+    2. **Carry propagation**: A short sequential scan over the block totals gives each block its carry-in.
+    3. **Block scan**: Every block scans its own elements in parallel, starting from its carry-in.
+
+    Done over the whole array, pass 1 and pass 3 each stream the entire input from memory. Here the array is processed
+    in tiles of (workers x block) elements instead, with the block sized to the L2 cache: when pass 3 runs, the block a
+    worker scans is usually still in its L2 from pass 1, so the second read is a cache hit rather than DRAM traffic.
+    The carry is threaded from one tile to the next.
+
+    Unlike std::inclusive_scan with std::execution::par on libstdc++, this needs no TBB.
+*/
+
+// -std=c++17 -O2 -pthread (add -ltbb with libstdc++ for the std::execution comparisons)
+
+namespace scan {
+
+// Block length in elements: half the L2 (the other half is left for the output and everything else)
+template <class T>
+std::size_t blockSize() {
+    long l2 = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (l2 <= 0) {
+        l2 = 256 * 1024;
+    }
+    return std::max<std::size_t>(1024, static_cast<std::size_t>(l2) / 2 / sizeof(T));
+}
+
+namespace detail {
+
+// Scans [first, last) into out starting from carry. inclusive: out[i] = carry op in[0..i]; exclusive: carry op in[0..i)
+template <bool Inclusive, class InIt, class OutIt, class T, class BinaryOp>
+T scanBlock(InIt first, InIt last, OutIt out, T carry, BinaryOp op) {
+    for (; first != last; ++first, ++out) {
+        T value = *first;  // Read before writing so in-place scans work
+        if constexpr (Inclusive) {
+            carry = op(carry, value);
+            *out = carry;
+        } else {
+            *out = carry;
+            carry = op(carry, value);
+        }
+    }
+    return carry;
+}
+
+template <bool Inclusive, class RandomIt, class OutIt, class T, class BinaryOp>
+OutIt scan(ws::ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out, T init, BinaryOp op) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    ws::WorkStealingPool& pool = policy.get();
+    const std::size_t block = blockSize<T>();
+    const std::size_t blocksPerTile = pool.size();
+    const std::size_t tile = block * blocksPerTile;
+
+    std::vector<T> carries(blocksPerTile);
+    T carry = init;
+    for (std::size_t tileBegin = 0; tileBegin < n; tileBegin += tile) {
+        const std::size_t tileEnd = std::min(n, tileBegin + tile);
+        const std::size_t blocks = (tileEnd - tileBegin + block - 1) / block;
+        auto blockBegin = [&](std::size_t b) { return tileBegin + b * block; };
+        auto blockEnd = [&](std::size_t b) { return std::min(tileEnd, tileBegin + (b + 1) * block); };
+
+        if (blocks == 1) {
+            carry = scanBlock<Inclusive>(first + tileBegin, first + tileEnd, out + tileBegin, carry, op);
+            continue;
+        }
+
+        // Pass 1: total of every block but the last (its total is only needed for the next tile)
+        pool.parallelFor(0, blocks - 1, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t b = lo; b < hi; ++b) {
+                auto begin = first + blockBegin(b);
+                carries[b] = std::accumulate(begin + 1, first + blockEnd(b), T(*begin), op);
+            }
+        });
+
+        // Carry propagation: exclusive scan of the block totals, seeded with the previous tile's carry
+        for (std::size_t b = 0; b < blocks - 1; ++b) {
+            T total = carries[b];
+            carries[b] = carry;
+            carry = op(carry, total);
+        }
+        carries[blocks - 1] = carry;
+
+        // Pass 2: scan every block from its carry-in; the tile was just read in pass 1, so it is likely still cached
+        T tileCarry = carry;
+        pool.parallelFor(0, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t b = lo; b < hi; ++b) {
+                T result = scanBlock<Inclusive>(first + blockBegin(b), first + blockEnd(b), out + blockBegin(b),
+                                                carries[b], op);
+                if (b == blocks - 1) {
+                    tileCarry = result;
+                }
+            }
+        });
+        carry = tileCarry;
+    }
+    return out + n;
+}
+
+}  // namespace detail
+
+template <class RandomIt, class OutIt, class BinaryOp, class T>
+OutIt inclusiveScan(ws::ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out, BinaryOp op, T init) {
+    return detail::scan<true>(policy, first, last, out, init, op);
+}
+
+template <class RandomIt, class OutIt>
+OutIt inclusiveScan(ws::ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    return detail::scan<true>(policy, first, last, out, T{}, std::plus<>{});
+}
+
+template <class RandomIt, class OutIt, class T, class BinaryOp>
+OutIt exclusiveScan(ws::ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out, T init, BinaryOp op) {
+    return detail::scan<false>(policy, first, last, out, init, op);
+}
+
+template <class RandomIt, class OutIt, class T>
+OutIt exclusiveScan(ws::ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out, T init) {
+    return detail::scan<false>(policy, first, last, out, init, std::plus<>{});
+}
+
+// Single pass of the same blocking: one L2-sized block per task, block totals combined in order
+template <class RandomIt, class T, class BinaryOp>
+T reduce(ws::ParallelPolicy policy, RandomIt first, RandomIt last, T init, BinaryOp op) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t block = blockSize<T>();
+    const std::size_t blocks = (n + block - 1) / block;
+    std::vector<T> totals(blocks);
+    policy.get().parallelFor(0, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t b = lo; b < hi; ++b) {
+            auto begin = first + b * block;
+            totals[b] = std::accumulate(begin + 1, first + std::min(n, (b + 1) * block), T(*begin), op);
+        }
+    });
+    for (const T& t : totals) {
+        init = op(init, t);
+    }
+    return init;
+}
+
+}  // namespace scan
+
+template <class F>
+double timeIt(F&& f, int reps = 10) {
+    f();  // Warmup
+    std::vector<double> samples;
+    for (int i = 0; i < reps; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        samples.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];  // Median
+}
+
+int main() {
+    // Same kind of input as the parallel_algorithms example, as 64-bit values so the sums do not overflow
+    std::vector<long long> data(16'000'000);
+    std::iota(data.begin(), data.end(), 1);
+    std::vector<long long> expected(data.size());
+    std::inclusive_scan(data.begin(), data.end(), expected.begin());
+    std::vector<long long> output(data.size());
+
+    std::cout << "Block size: " << scan::blockSize<long long>() << " elements, workers: "
+              << ws::WorkStealingPool::instance().size() << "\n";
+
+    // Example 1: inclusive scan, every std policy vs the blocked two-pass scan.
+    // output is cleared before each run, so a scan that leaves elements unwritten fails the check.
+    auto clear = [&] { std::fill(output.begin(), output.end(), 0LL); };
+    std::cout << std::boolalpha;
+    clear();
+    double seq = timeIt([&] { std::inclusive_scan(std::execution::seq, data.begin(), data.end(), output.begin()); });
+    std::cout << "inclusive_scan seq:       " << seq * 1e3 << " ms, correct: " << (output == expected) << "\n";
+    clear();
+    double par = timeIt([&] { std::inclusive_scan(std::execution::par, data.begin(), data.end(), output.begin()); });
+    std::cout << "inclusive_scan par:       " << par * 1e3 << " ms, correct: " << (output == expected) << "\n";
+    clear();
+    double parUnseq = timeIt([&] {
+        std::inclusive_scan(std::execution::par_unseq, data.begin(), data.end(), output.begin());
+    });
+    std::cout << "inclusive_scan par_unseq: " << parUnseq * 1e3 << " ms, correct: " << (output == expected) << "\n";
+    clear();
+    double blocked = timeIt([&] { scan::inclusiveScan(ws::par, data.begin(), data.end(), output.begin()); });
+    std::cout << "scan::inclusiveScan:      " << blocked * 1e3 << " ms, correct: " << (output == expected) << "\n";
+
+    // Example 2: exclusive scan in place
+    std::vector<long long> inPlace = data;
+    scan::exclusiveScan(ws::par, inPlace.begin(), inPlace.end(), inPlace.begin(), 0LL);
+    std::cout << "exclusive scan in place correct: "
+              << (inPlace[0] == 0 && std::equal(inPlace.begin() + 1, inPlace.end(), expected.begin())) << "\n";
+
+    // Example 3: reduce
+    long long stdSum = 0, blockedSum = 0;
+    double stdReduce = timeIt([&] { stdSum = std::reduce(std::execution::par, data.begin(), data.end(), 0LL); });
+    double blockedReduce =
+        timeIt([&] { blockedSum = scan::reduce(ws::par, data.begin(), data.end(), 0LL, std::plus<>{}); });
+    std::cout << "std::reduce par: " << stdReduce * 1e3 << " ms, scan::reduce: " << blockedReduce * 1e3
+              << " ms, equal: " << (stdSum == blockedSum) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <numeric> // For std::iota
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+
+#include "work_stealing_pool.h"
+
+/*
+    Benchmark set-up in the parallel_algorithms example (std::iota followed by std::shuffle) is sequential, and for
+    large inputs it takes longer than the parallel sort it feeds. This example generates the same data in parallel:
+
+    1. **Sharded iota / fill**: Each task writes its own slice; slice i starts at value + i, so there is nothing to
+       coordinate.
+    2. **Parallel shuffle** (per-block shuffle with a cross-block exchange):
+       - Every element is sent to a uniformly random bucket. Like a radix sort pass, each chunk first counts how many
+         of its elements go to each bucket, an exclusive scan turns counts into offsets, and each chunk scatters its
+         elements. The random numbers are regenerated from the same seed in the scatter phase instead of being stored.
+       - Every bucket is then Fisher-Yates shuffled on its own.
+       Random bucket + random order inside the bucket is the same as sorting by a random key, so the result is a
+       uniformly random permutation.
+    3. **Deterministic seeding**: Every chunk and bucket gets its own generator derived from (seed, phase, index) with
+       SplitMix64, and the chunk/bucket layout depends only on the input size. The same seed gives the same
+       permutation for any number of workers, any schedule and any standard library (std::shuffle and
+       std::uniform_int_distribution are implementation-defined, so they are not used).
+*/
+
+// -std=c++17 -O2 -pthread
+
+namespace gen {
+
+// SplitMix64: tiny, fast, and good enough for shuffling; also used to derive independent seeds
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t operator()() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform value in [0, range) with Lemire's multiply-shift (bias is negligible for range << 2^64)
+    std::uint64_t below(std::uint64_t range) {
+#ifdef __SIZEOF_INT128__
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>((*this)()) * range) >> 64);
+#else
+        return (*this)() % range;
+#endif
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// Independent stream for (seed, phase, index)
+inline SplitMix64 stream(std::uint64_t seed, std::uint64_t phase, std::uint64_t index) {
+    SplitMix64 mix(seed ^ (phase * 0xd1b54a32d192ed03ULL));
+    return SplitMix64(mix() ^ (index * 0x8cb92ba72f3d8dd7ULL));
+}
+
+template <class RandomIt, class T>
+void iota(ws::ParallelPolicy policy, RandomIt first, RandomIt last, T value) {
+    auto n = static_cast<std::size_t>(last - first);
+    ws::WorkStealingPool& pool = policy.get();
+    pool.parallelFor(0, n, pool.defaultGrain(n), [&](std::size_t lo, std::size_t hi) {
+        std::iota(first + lo, first + hi, static_cast<T>(value + static_cast<T>(lo)));
+    });
+}
+
+template <class RandomIt, class T>
+void fill(ws::ParallelPolicy policy, RandomIt first, RandomIt last, const T& value) {
+    auto n = static_cast<std::size_t>(last - first);
+    ws::WorkStealingPool& pool = policy.get();
+    pool.parallelFor(0, n, pool.defaultGrain(n), [&](std::size_t lo, std::size_t hi) {
+        std::fill(first + lo, first + hi, value);
+    });
+}
+
+// Sequential Fisher-Yates with our generator (reproducible across standard libraries)
+template <class RandomIt>
+void fisherYates(RandomIt first, RandomIt last, SplitMix64& rng) {
+    auto n = static_cast<std::uint64_t>(last - first);
+    for (std::uint64_t i = n; i > 1; --i) {
+        std::iter_swap(first + (i - 1), first + rng.below(i));
+    }
+}
+
+template <class RandomIt>
+void shuffle(ws::ParallelPolicy policy, RandomIt first, RandomIt last, std::uint64_t seed) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr std::size_t kBlock = 1 << 16;     // Target elements per chunk / bucket
+    constexpr std::size_t kMaxBlocks = 1024;    // Bounds the chunks x buckets count table to 1M entries
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    // Layout depends on n only, never on the worker count, so the output is reproducible
+    const std::size_t blocks = std::clamp<std::size_t>((n + kBlock - 1) / kBlock, 1, kMaxBlocks);
+    ws::WorkStealingPool& pool = policy.get();
+    if (blocks == 1) {
+        SplitMix64 rng = stream(seed, 2, 0);
+        fisherYates(first, last, rng);
+        return;
+    }
+    const std::size_t chunkSize = (n + blocks - 1) / blocks;
+    auto chunkBegin = [&](std::size_t c) { return std::min(n, c * chunkSize); };
+    auto chunkEnd = [&](std::size_t c) { return std::min(n, (c + 1) * chunkSize); };
+
+    // Phase 1: per-chunk bucket counts
+    std::vector<std::size_t> counts(blocks * blocks);  // counts[chunk * blocks + bucket]
+    pool.parallelFor(0, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; ++c) {
+            SplitMix64 rng = stream(seed, 1, c);
+            std::size_t* row = &counts[c * blocks];
+            for (std::size_t i = chunkBegin(c); i < chunkEnd(c); ++i) {
+                ++row[rng.below(blocks)];
+            }
+        }
+    });
+
+    // Exclusive scan, bucket-major: bucket b occupies [bucketStart[b], bucketStart[b + 1])
+    std::vector<std::size_t> bucketStart(blocks + 1);
+    std::size_t offset = 0;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        bucketStart[b] = offset;
+        for (std::size_t c = 0; c < blocks; ++c) {
+            std::size_t count = counts[c * blocks + b];
+            counts[c * blocks + b] = offset;
+            offset += count;
+        }
+    }
+    bucketStart[blocks] = n;
+
+    // Phase 2: scatter, replaying the same random sequence as phase 1
+    std::vector<T> buffer(n);
+    pool.parallelFor(0, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; ++c) {
+            SplitMix64 rng = stream(seed, 1, c);
+            std::size_t* row = &counts[c * blocks];
+            for (std::size_t i = chunkBegin(c); i < chunkEnd(c); ++i) {
+                buffer[row[rng.below(blocks)]++] = std::move(first[i]);
+            }
+        }
+    });
+
+    // Phase 3: shuffle every bucket independently and move it back
+    pool.parallelFor(0, blocks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t b = lo; b < hi; ++b) {
+            SplitMix64 rng = stream(seed, 2, b);
+            auto begin = buffer.begin() + bucketStart[b];
+            auto end = buffer.begin() + bucketStart[b + 1];
+            fisherYates(begin, end, rng);
+            std::move(begin, end, first + bucketStart[b]);
+        }
+    });
+}
+
+}  // namespace gen
+
+template <class F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+int main() {
+    constexpr std::size_t n = 20'000'000;
+    constexpr std::uint64_t seed = 42;
+
+    // Example 1: The sequential set-up from parallel_algorithms
+    std::vector<int> sequential(n);
+    double seqIota = timeIt([&] { std::iota(sequential.begin(), sequential.end(), 1); });
+    double seqShuffle = timeIt([&] { std::shuffle(sequential.begin(), sequential.end(), std::mt19937{seed}); });
+    std::cout << "std::iota: " << seqIota << " s, std::shuffle: " << seqShuffle << " s\n";
+
+    // Example 2: Parallel iota + shuffle
+    std::vector<int> data(n);
+    double parIota = timeIt([&] { gen::iota(ws::par, data.begin(), data.end(), 1); });
+    double parShuffle = timeIt([&] { gen::shuffle(ws::par, data.begin(), data.end(), seed); });
+    std::cout << "gen::iota: " << parIota << " s, gen::shuffle: " << parShuffle << " s\n";
+
+    // Example 3: Reproducibility - same seed on a differently sized pool gives the same permutation
+    std::vector<int> again(n);
+    ws::WorkStealingPool other(3);
+    gen::iota(ws::on(other), again.begin(), again.end(), 1);
+    gen::shuffle(ws::on(other), again.begin(), again.end(), seed);
+    std::cout << std::boolalpha << "Same permutation on a 3-worker pool: " << (again == data) << "\n";
+
+    // The result is still a permutation of 1..n
+    ws::sort(ws::par, again.begin(), again.end());
+    std::vector<int> ordered(n);
+    gen::iota(ws::par, ordered.begin(), ordered.end(), 1);
+    std::cout << "Is a permutation: " << (again == ordered) << "\n";
+
+    return 0;
+}
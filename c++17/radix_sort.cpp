@@ -0,0 +1,216 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <execution>
+#include <numeric> // For std::iota
+#include <random>
+#include <chrono>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "work_stealing_pool.h"
+
+/*
+    Sorting shuffled integers with a comparison sort costs O(n log n) comparisons and a lot of unpredictable branches.
+    An LSD (least significant digit) radix sort looks at the key one 8-bit digit at a time instead, and every pass is
+    a linear, branch-free counting sort. Parallelizing it takes three phases per pass:
+
+    1. **Histogram**: The input is split into one chunk per task; each task counts how many of its keys fall into
+       each of the 256 buckets (per-thread histograms, no shared counters).
+    2. **Prefix sum**: Bucket-major, chunk-minor exclusive scan of all histograms. Chunk c gets the slot right after
+       every key of a smaller digit and after the keys of the same digit from chunks 0..c-1, so the pass is stable.
+    3. **Scatter**: Each task writes its keys (and values, for key-value pairs) to their final positions in the
+       output buffer. No two tasks write to the same slot, so no synchronization is needed.
+
+    Passes whose digit is the same for every key (e.g. the high bytes of small values) are skipped entirely.
+    Signed keys are mapped to unsigned by flipping the sign bit so negative numbers order before positive ones.
+*/
+
+// -std=c++17 -O2 -pthread (add -ltbb with libstdc++ for the std::execution::par comparison)
+
+namespace radix {
+
+constexpr int kDigitBits = 8;
+constexpr std::size_t kBuckets = std::size_t{1} << kDigitBits;
+
+template <class Key>
+using Unsigned = std::make_unsigned_t<Key>;
+
+// Order-preserving mapping of a (possibly signed) key to an unsigned integer
+template <class Key>
+Unsigned<Key> toBits(Key key) {
+    auto bits = static_cast<Unsigned<Key>>(key);
+    if constexpr (std::is_signed_v<Key>) {
+        bits ^= Unsigned<Key>{1} << (sizeof(Key) * 8 - 1);
+    }
+    return bits;
+}
+
+// Empty payload used when sorting plain keys
+struct NoValues {};
+
+template <class Value>
+Value* dataOf(std::vector<Value>& values) { return values.data(); }
+
+inline std::nullptr_t dataOf(NoValues&) { return nullptr; }
+
+template <class Key, class Values>
+void sortImpl(ws::WorkStealingPool& pool, std::vector<Key>& keys, Values& values) {
+    static_assert(std::is_integral_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8),
+                  "radix::sort handles 32- and 64-bit integer keys");
+    constexpr bool hasValues = !std::is_same_v<Values, NoValues>;
+    const std::size_t n = keys.size();
+    if (n < 2) {
+        return;
+    }
+
+    // Few chunks for small inputs, a couple per worker for large ones
+    const std::size_t chunks = std::clamp<std::size_t>(n / 65536, 1, pool.size() * 2);
+    const std::size_t chunkSize = (n + chunks - 1) / chunks;
+
+    std::vector<Key> keyBuf(n);
+    Values valueBuf{};
+    if constexpr (hasValues) {
+        valueBuf.resize(n);
+    }
+    std::vector<std::array<std::size_t, kBuckets>> hist(chunks);
+
+    Key* src = keys.data();
+    Key* dst = keyBuf.data();
+    auto srcVal = dataOf(values);
+    auto dstVal = dataOf(valueBuf);
+
+    for (int shift = 0; shift < static_cast<int>(sizeof(Key) * 8); shift += kDigitBits) {
+        auto digit = [shift](Key k) { return static_cast<std::size_t>((toBits(k) >> shift) & (kBuckets - 1)); };
+
+        // Phase 1: per-chunk histograms
+        pool.parallelFor(0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t c = lo; c < hi; ++c) {
+                auto& h = hist[c];
+                h.fill(0);
+                const std::size_t end = std::min(n, (c + 1) * chunkSize);
+                for (std::size_t i = c * chunkSize; i < end; ++i) {
+                    ++h[digit(src[i])];
+                }
+            }
+        });
+
+        // Every key has the same digit: this pass would be an identity permutation
+        std::size_t firstBucket = digit(src[0]);
+        std::size_t inFirstBucket = 0;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            inFirstBucket += hist[c][firstBucket];
+        }
+        if (inFirstBucket == n) {
+            continue;
+        }
+
+        // Phase 2: exclusive scan, bucket-major then chunk, turning counts into write offsets
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::size_t count = hist[c][b];
+                hist[c][b] = offset;
+                offset += count;
+            }
+        }
+
+        // Phase 3: scatter
+        pool.parallelFor(0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t c = lo; c < hi; ++c) {
+                auto& pos = hist[c];
+                const std::size_t end = std::min(n, (c + 1) * chunkSize);
+                for (std::size_t i = c * chunkSize; i < end; ++i) {
+                    std::size_t to = pos[digit(src[i])]++;
+                    dst[to] = src[i];
+                    if constexpr (hasValues) {
+                        dstVal[to] = std::move(srcVal[i]);
+                    }
+                }
+            }
+        });
+
+        std::swap(src, dst);
+        std::swap(srcVal, dstVal);
+    }
+
+    // An odd number of executed passes leaves the result in the scratch buffer
+    if (src != keys.data()) {
+        keys.swap(keyBuf);
+        if constexpr (hasValues) {
+            values.swap(valueBuf);
+        }
+    }
+}
+
+template <class Key>
+void sort(ws::ParallelPolicy policy, std::vector<Key>& keys) {
+    NoValues none;
+    ws::WorkStealingPool& pool = policy.get();
+    pool.run([&] { sortImpl(pool, keys, none); });
+}
+
+// Sorts keys and permutes values the same way (stable: equal keys keep their relative order).
+// Throws std::invalid_argument unless there is exactly one value per key.
+template <class Key, class Value>
+void sortPairs(ws::ParallelPolicy policy, std::vector<Key>& keys, std::vector<Value>& values) {
+    if (values.size() != keys.size()) {
+        throw std::invalid_argument("radix::sortPairs: keys and values differ in size");
+    }
+    ws::WorkStealingPool& pool = policy.get();
+    pool.run([&] { sortImpl(pool, keys, values); });
+}
+
+}  // namespace radix
+
+template <class F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+int main() {
+    // Example 1: Same workload as parallel_algorithms - a shuffled vector of int
+    std::vector<int> data(10'000'000);
+    std::iota(data.begin(), data.end(), -5'000'000);
+    std::shuffle(data.begin(), data.end(), std::mt19937{42});
+
+    auto a = data;
+    auto b = data;
+    auto c = data;
+    double parSort = timeIt([&] { std::sort(std::execution::par, a.begin(), a.end()); });
+    double wsSort = timeIt([&] { ws::sort(ws::par, b.begin(), b.end()); });
+    double radixSort = timeIt([&] { radix::sort(ws::par, c); });
+
+    std::cout << "std::sort(par) took:   " << parSort << " seconds.\n";
+    std::cout << "ws::sort(par) took:    " << wsSort << " seconds.\n";
+    std::cout << "radix::sort took:      " << radixSort << " seconds. Matches std::sort: " << std::boolalpha
+              << (a == c) << "\n";
+
+    // Example 2: 64-bit keys
+    std::vector<std::uint64_t> wide(data.size());
+    std::mt19937_64 rng{7};
+    for (auto& k : wide) {
+        k = rng();
+    }
+    auto wideRef = wide;
+    double wideStd = timeIt([&] { std::sort(std::execution::par, wideRef.begin(), wideRef.end()); });
+    double wideRadix = timeIt([&] { radix::sort(ws::par, wide); });
+    std::cout << "uint64 std::sort(par): " << wideStd << " seconds, radix::sort: " << wideRadix
+              << " seconds. Matches: " << (wide == wideRef) << "\n";
+
+    // Example 3: Key-value pairs, values follow their keys
+    std::vector<int> keys = {5, -3, 5, 0, -3, 9};
+    std::vector<char> values = {'a', 'b', 'c', 'd', 'e', 'f'};
+    radix::sortPairs(ws::par, keys, values);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std::cout << keys[i] << ":" << values[i] << " ";  // -3:b -3:e 0:d 5:a 5:c 9:f
+    }
+    std::cout << "\n";
+
+    return 0;
+}
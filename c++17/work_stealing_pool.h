@@ -0,0 +1,538 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+    A self-contained work-stealing thread pool and an execution-policy object built on top of it.
+
+    libstdc++ only runs std::execution::par in parallel when the program is linked against TBB; without it the
+    "parallel" algorithms quietly fall back to sequential code. This header provides the same fork-join machinery
+    with nothing but <thread> and <atomic>:
+
+    1. **Chase-Lev deques**: Every worker owns a deque. The owner pushes and pops at the bottom (LIFO, cache friendly),
+       idle workers steal from the top (FIFO, takes the oldest and therefore largest piece of work).
+    2. **Randomized stealing**: A worker that runs out of work picks victims at random, which spreads contention
+       instead of having every thief hammer worker 0.
+    3. **Helping joins**: A thread waiting for a forked task keeps executing other tasks instead of blocking, so
+       nested parallelism (e.g. a recursive merge sort) never deadlocks and never idles a core.
+    4. **ws::par**: An execution-policy object. ws::sort / ws::transform / ws::reduce / ws::for_each take it as their
+       first argument exactly like the std:: versions take std::execution::par.
+
+    The std:: algorithms cannot be overloaded for a user-defined policy (specializing std::is_execution_policy is not
+    allowed), so the algorithms live in namespace ws with the same signatures.
+*/
+
+// -std=c++17 -pthread
+
+namespace ws {
+
+// Base for everything that can sit in a deque. Tasks are owned by whoever forked them (usually a stack frame).
+class TaskBase {
+public:
+    virtual void run() noexcept = 0;
+
+protected:
+    ~TaskBase() = default;
+};
+
+// Chase-Lev work-stealing deque ("Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013).
+// push/pop are called by the owning worker only, steal may be called by any thread.
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(std::size_t capacity = 256) {
+        arrays_.push_back(std::make_unique<Array>(capacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    void push(TaskBase* task) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(a->capacity) - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    TaskBase* pop() {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        TaskBase* task = nullptr;
+        if (t <= b) {
+            task = a->get(b);
+            if (t == b) {
+                // Last element: race against thieves for it
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    task = nullptr;
+                }
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    TaskBase* steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        TaskBase* task = array_.load(std::memory_order_acquire)->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;  // Lost the race to the owner or another thief
+        }
+        return task;
+    }
+
+    bool empty() const {
+        return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Array {
+        explicit Array(std::size_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<TaskBase*>[cap]) {}
+
+        TaskBase* get(std::int64_t i) const {
+            return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+        void put(std::int64_t i, TaskBase* task) {
+            slots[static_cast<std::size_t>(i) & mask].store(task, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity;  // Always a power of two
+        std::size_t mask;
+        std::unique_ptr<std::atomic<TaskBase*>[]> slots;
+    };
+
+    Array* grow(Array* old, std::int64_t t, std::int64_t b) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Array* raw = bigger.get();
+        // Thieves may still be reading the old array, so it is retired only when the deque dies
+        arrays_.push_back(std::move(bigger));
+        array_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()))
+        : workers_(threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i].thread = std::thread([this, i] { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_.store(true, std::memory_order_seq_cst);
+        }
+        sleepCv_.notify_all();
+        for (auto& w : workers_) {
+            w.thread.join();
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Runs f() on a pool worker and blocks until it returns. Called from a worker it simply calls f().
+    template <class F>
+    void run(F&& f) {
+        if (currentIndex() >= 0) {
+            f();
+            return;
+        }
+        ExternalTask<F> task(f);
+        submit(&task);
+        task.wait();
+        if (task.error) {
+            std::rethrow_exception(task.error);
+        }
+    }
+
+    // Fork-join: runs a() and b() potentially in parallel and returns when both are done.
+    // b() is made stealable while the calling thread executes a(); must be called from a pool worker.
+    template <class A, class B>
+    void invoke(A&& a, B&& b) {
+        JoinTask<B> forked(b);
+        submit(&forked);
+        std::exception_ptr error;
+        try {
+            a();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // Help with outstanding work until the forked half has been executed (by us or by a thief)
+        while (!forked.done.load(std::memory_order_acquire)) {
+            if (TaskBase* task = findTask(currentIndex())) {
+                task->run();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if (forked.error) {
+            std::rethrow_exception(forked.error);
+        }
+    }
+
+    // Calls body(lo, hi) over [begin, end) split into chunks of at least grain elements.
+    template <class Body>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Body&& body) {
+        run([&] { splitFor(begin, end, std::max<std::size_t>(grain, 1), body); });
+    }
+
+    // Chunk size that yields a few chunks per worker so stealing can even out imbalance
+    std::size_t defaultGrain(std::size_t n, std::size_t minimum = 2048) const {
+        return std::max<std::size_t>(minimum, n / (size() * 8) + 1);
+    }
+
+    static WorkStealingPool& instance() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+private:
+    template <class F>
+    struct JoinTask final : TaskBase {
+        explicit JoinTask(F& fn) : f(fn) {}
+        void run() noexcept override {
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.store(true, std::memory_order_release);
+        }
+        F& f;
+        std::exception_ptr error;
+        std::atomic<bool> done{false};
+    };
+
+    template <class F>
+    struct ExternalTask final : TaskBase {
+        explicit ExternalTask(F& fn) : f(fn) {}
+        void run() noexcept override {
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(m);
+            done = true;
+            cv.notify_one();  // Under the lock: once wait() sees done, the task (and cv) may be destroyed
+        }
+        void wait() {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [this] { return done; });
+        }
+        F& f;
+        std::exception_ptr error;
+        std::mutex m;
+        std::condition_variable cv;
+        bool done = false;
+    };
+
+    struct Worker {
+        ChaseLevDeque deque;
+        std::thread thread;
+    };
+
+    template <class Body>
+    void splitFor(std::size_t begin, std::size_t end, std::size_t grain, Body& body) {
+        if (end - begin <= grain) {
+            body(begin, end);
+            return;
+        }
+        std::size_t mid = begin + (end - begin) / 2;
+        invoke([&] { splitFor(begin, mid, grain, body); }, [&] { splitFor(mid, end, grain, body); });
+    }
+
+    int currentIndex() const {
+        return tlsPool() == this ? tlsIndex() : -1;
+    }
+
+    static const WorkStealingPool*& tlsPool() {
+        static thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& tlsIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    void submit(TaskBase* task) {
+        int index = currentIndex();
+        if (index >= 0) {
+            workers_[index].deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            inject_.push_back(task);
+            injectSize_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Pairs with the fence in workerLoop(): either we see the sleeper or it sees our task
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            sleepCv_.notify_one();
+        }
+    }
+
+    TaskBase* findTask(int self) {
+        if (self >= 0) {
+            if (TaskBase* task = workers_[self].deque.pop()) {
+                return task;
+            }
+        }
+        // Randomized stealing: start at a random victim and sweep once around
+        std::size_t n = workers_.size();
+        std::size_t start = nextRandom() % n;
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t victim = (start + k) % n;
+            if (static_cast<int>(victim) == self) {
+                continue;
+            }
+            if (TaskBase* task = workers_[victim].deque.steal()) {
+                return task;
+            }
+        }
+        if (injectSize_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            if (!inject_.empty()) {
+                TaskBase* task = inject_.front();
+                inject_.pop_front();
+                injectSize_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    bool hasVisibleWork() const {
+        if (injectSize_.load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+        for (const auto& w : workers_) {
+            if (!w.deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::uint64_t nextRandom() {
+        static thread_local std::uint64_t state =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        // xorshift64
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    void workerLoop(int index) {
+        tlsPool() = this;
+        tlsIndex() = index;
+        int idleRounds = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (TaskBase* task = findTask(index)) {
+                task->run();
+                idleRounds = 0;
+                continue;
+            }
+            if (++idleRounds < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasVisibleWork() && !stop_.load(std::memory_order_acquire)) {
+                sleepCv_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            idleRounds = 0;
+        }
+    }
+
+    std::vector<Worker> workers_;
+
+    std::mutex injectMutex_;                 // Queue for tasks submitted from outside the pool
+    std::deque<TaskBase*> inject_;
+    std::atomic<std::size_t> injectSize_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+// Execution policy: which pool to run on. ws::par uses the process-wide pool sized to all cores.
+struct ParallelPolicy {
+    WorkStealingPool* pool;
+    WorkStealingPool& get() const { return pool ? *pool : WorkStealingPool::instance(); }
+};
+
+inline constexpr ParallelPolicy par{nullptr};
+
+inline ParallelPolicy on(WorkStealingPool& pool) { return ParallelPolicy{&pool}; }
+
+namespace detail {
+
+constexpr std::size_t kSortCutoff = 8192;
+constexpr std::size_t kMergeCutoff = 8192;
+
+// Merges [first1, last1) and [first2, last2) into out, splitting the larger run at its median and the smaller one
+// at the matching lower_bound so both halves can be merged independently.
+template <class It1, class It2, class Out, class Compare>
+void parallelMerge(WorkStealingPool& pool, It1 first1, It1 last1, It2 first2, It2 last2, Out out, Compare comp) {
+    auto n1 = last1 - first1;
+    auto n2 = last2 - first2;
+    if (static_cast<std::size_t>(n1 + n2) <= kMergeCutoff) {
+        std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+                   std::make_move_iterator(first2), std::make_move_iterator(last2), out, comp);
+        return;
+    }
+    if (n1 < n2) {
+        // Keep the first range the larger one; swapping ranges keeps the merge stable only for equal keys,
+        // which std::sort does not promise anyway
+        parallelMerge(pool, first2, last2, first1, last1, out, comp);
+        return;
+    }
+    It1 mid1 = first1 + n1 / 2;
+    It2 mid2 = std::lower_bound(first2, last2, *mid1, comp);
+    Out outMid = out + (mid1 - first1) + (mid2 - first2);
+    pool.invoke([&] { parallelMerge(pool, first1, mid1, first2, mid2, out, comp); },
+                [&] { parallelMerge(pool, mid1, last1, mid2, last2, outMid, comp); });
+}
+
+// Sorts [first, last) using buf (same length) as scratch space. Result ends up in [first, last).
+template <class It, class BufIt, class Compare>
+void parallelMergeSort(WorkStealingPool& pool, It first, It last, BufIt buf, Compare comp) {
+    auto n = last - first;
+    if (static_cast<std::size_t>(n) <= kSortCutoff) {
+        std::sort(first, last, comp);
+        return;
+    }
+    auto half = n / 2;
+    It mid = first + half;
+    pool.invoke([&] { parallelMergeSort(pool, first, mid, buf, comp); },
+                [&] { parallelMergeSort(pool, mid, last, buf + half, comp); });
+    // Merge both sorted halves into the buffer, then move back in parallel
+    parallelMerge(pool, first, mid, mid, last, buf, comp);
+    pool.parallelFor(0, static_cast<std::size_t>(n), pool.defaultGrain(n), [&](std::size_t lo, std::size_t hi) {
+        std::move(buf + lo, buf + hi, first + lo);
+    });
+}
+
+}  // namespace detail
+
+template <class RandomIt, class Compare>
+void sort(ParallelPolicy policy, RandomIt first, RandomIt last, Compare comp) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto n = last - first;
+    if (n < 2) {
+        return;
+    }
+    WorkStealingPool& pool = policy.get();
+    std::vector<T> buf(static_cast<std::size_t>(n));
+    pool.run([&] { detail::parallelMergeSort(pool, first, last, buf.begin(), comp); });
+}
+
+template <class RandomIt>
+void sort(ParallelPolicy policy, RandomIt first, RandomIt last) {
+    ws::sort(policy, first, last, std::less<>{});
+}
+
+template <class RandomIt, class OutIt, class UnaryOp>
+OutIt transform(ParallelPolicy policy, RandomIt first, RandomIt last, OutIt out, UnaryOp op) {
+    auto n = static_cast<std::size_t>(last - first);
+    WorkStealingPool& pool = policy.get();
+    pool.parallelFor(0, n, pool.defaultGrain(n), [&](std::size_t lo, std::size_t hi) {
+        std::transform(first + lo, first + hi, out + lo, op);
+    });
+    return out + n;
+}
+
+template <class RandomIt, class UnaryFn>
+void for_each(ParallelPolicy policy, RandomIt first, RandomIt last, UnaryFn f) {
+    auto n = static_cast<std::size_t>(last - first);
+    WorkStealingPool& pool = policy.get();
+    pool.parallelFor(0, n, pool.defaultGrain(n), [&](std::size_t lo, std::size_t hi) {
+        std::for_each(first + lo, first + hi, f);
+    });
+}
+
+template <class RandomIt, class T, class BinaryOp>
+T reduce(ParallelPolicy policy, RandomIt first, RandomIt last, T init, BinaryOp op) {
+    auto n = static_cast<std::size_t>(last - first);
+    WorkStealingPool& pool = policy.get();
+    std::size_t grain = pool.defaultGrain(n);
+    std::size_t chunks = (n + grain - 1) / grain;
+    if (chunks <= 1) {
+        return std::accumulate(first, last, init, op);
+    }
+    // One partial per chunk, combined in order so non-commutative (but associative) ops still work
+    std::vector<T> partial(chunks);
+    pool.parallelFor(0, chunks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; ++c) {
+            auto b = first + c * grain;
+            auto e = first + std::min(n, (c + 1) * grain);
+            partial[c] = std::accumulate(b + 1, e, T(*b), op);
+        }
+    });
+    for (const T& p : partial) {
+        init = op(init, p);
+    }
+    return init;
+}
+
+template <class RandomIt>
+typename std::iterator_traits<RandomIt>::value_type reduce(ParallelPolicy policy, RandomIt first, RandomIt last) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    return ws::reduce(policy, first, last, T{}, std::plus<>{});
+}
+
+}  // namespace ws
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "task.h"
+
+/*
+Asynchronous file I/O for coroutines: co_await async_read(fd, buffer, offset) / async_write(fd, buffer, offset).
+Regular files are always "ready" as far as epoll is concerned, so the readiness model of event_loop.h cannot overlap
+disk reads. IoService submits the read itself and resumes the coroutine when the data is there:
+- io_uring backend (Linux 5.1+): every awaited operation becomes one submission queue entry. Entries are only
+  written to the shared ring while the coroutines run; IoService::run() then hands the whole batch to the kernel and
+  waits for completions with a single io_uring_enter() call, so N outstanding reads cost one system call per batch
+  instead of N.
+- Thread-pool backend: when io_uring is unavailable (old kernel, seccomp, io_uring_disabled) the operations are
+  executed with blocking pread/pwrite on a few worker threads and their completions are handed back in batches.
+Coroutines are always resumed on the thread that calls run(), whichever backend is in use. An I/O error is thrown
+from the co_await as std::system_error; the value of a successful co_await is the number of bytes transferred.
+*/
+
+// -std=c++20 -pthread, Linux only
+
+class IoService {
+public:
+    enum class Backend { Auto, IoUring, ThreadPool };
+
+    // One request in flight; lives in the awaiting coroutine's frame until it is resumed
+    struct Operation {
+        bool write = false;
+        int fd = -1;
+        iovec iov{};
+        off_t offset = 0;
+        long result = 0;  // Bytes transferred, or -errno
+        std::coroutine_handle<> handle;
+    };
+
+    explicit IoService(unsigned queueDepth = 64, Backend backend = Backend::Auto, unsigned fallbackThreads = 4) {
+        if (backend != Backend::ThreadPool) {
+            int err = setupRing(queueDepth);
+            if (err != 0 && backend == Backend::IoUring) {
+                throw std::system_error(err, std::generic_category(), "io_uring_setup");
+            }
+        }
+        if (ringFd_ < 0) {
+            workers_.reserve(fallbackThreads);
+            for (unsigned i = 0; i < std::max(1u, fallbackThreads); ++i) {
+                workers_.emplace_back([this] { workerLoop(); });
+            }
+        }
+        previous_ = current_;
+        current_ = this;
+    }
+
+    IoService(const IoService&) = delete;
+    IoService& operator=(const IoService&) = delete;
+
+    ~IoService() {
+        current_ = previous_;
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex_);
+            stop_ = true;
+        }
+        jobsCv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+        if (ringFd_ >= 0) {
+            munmap(sqes_, sqesBytes_);
+            if (cqRing_ != sqRing_) {
+                munmap(cqRing_, cqRingBytes_);
+            }
+            munmap(sqRing_, sqRingBytes_);
+            close(ringFd_);
+        }
+    }
+
+    // The service created most recently on this thread; used by async_read() / async_write()
+    static IoService& current() { return *current_; }
+
+    Backend backend() const { return ringFd_ >= 0 ? Backend::IoUring : Backend::ThreadPool; }
+
+    // Queues op; it is handed to the kernel (or a worker) by the next iteration of run()
+    void submit(Operation* op) {
+        ++pending_;
+        if (ringFd_ >= 0) {
+            backlog_.push_back(op);
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex_);
+                jobs_.push_back(op);
+            }
+            jobsCv_.notify_one();
+        }
+    }
+
+    // Starts task on this service without waiting for it; an exception escaping it terminates the program
+    void spawn(Task<void> task) { runDetached(std::move(task)); }
+
+    // Runs until every spawned coroutine has finished and no operation is outstanding
+    void run() {
+        while (true) {
+            while (!ready_.empty()) {
+                auto h = ready_.front();
+                ready_.pop_front();
+                h.resume();
+            }
+            if (pending_ == 0) {
+                return;
+            }
+            if (ringFd_ >= 0) {
+                submitAndReap();
+            } else {
+                collectCompletions();
+            }
+        }
+    }
+
+private:
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    static Detached runDetached(Task<void> task) { co_await task; }
+
+    static long sysIoUringSetup(unsigned entries, io_uring_params* p) {
+        return syscall(__NR_io_uring_setup, entries, p);
+    }
+
+    static long sysIoUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    // Returns 0 on success or the errno that made io_uring unusable
+    int setupRing(unsigned entries) {
+        io_uring_params p{};
+        long fd = sysIoUringSetup(entries, &p);
+        if (fd < 0) {
+            return errno;
+        }
+        ringFd_ = static_cast<int>(fd);
+        sqRingBytes_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sqRingBytes_ = cqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+        }
+        sqRing_ = mmap(nullptr, sqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_,
+                       IORING_OFF_SQ_RING);
+        cqRing_ = single ? sqRing_
+                         : mmap(nullptr, cqRingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_,
+                                IORING_OFF_CQ_RING);
+        sqesBytes_ = p.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqesBytes_, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+        if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            int err = errno;
+            if (sqes_ != MAP_FAILED) munmap(sqes_, sqesBytes_);
+            if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) munmap(cqRing_, cqRingBytes_);
+            if (sqRing_ != MAP_FAILED) munmap(sqRing_, sqRingBytes_);
+            close(ringFd_);
+            ringFd_ = -1;
+            return err;
+        }
+        auto* sq = static_cast<char*>(sqRing_);
+        auto* cq = static_cast<char*>(cqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        sqEntries_ = p.sq_entries;
+        cqHead_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        cqEntries_ = p.cq_entries;
+        return 0;
+    }
+
+    // Moves queued operations into free SQ slots, submits them and waits for at least one completion
+    void submitAndReap() {
+        unsigned tail = *sqTail_;  // Only this thread writes the tail
+        unsigned head = std::atomic_ref<unsigned>(*sqHead_).load(std::memory_order_acquire);
+        // Never have more requests in flight than the CQ can hold, or completions would be dropped
+        while (!backlog_.empty() && tail - head < sqEntries_ && inFlight_ < cqEntries_) {
+            Operation* op = backlog_.front();
+            backlog_.pop_front();
+            unsigned index = tail & sqMask_;
+            io_uring_sqe& sqe = sqes_[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            // READV/WRITEV rather than READ/WRITE: available since the first io_uring kernel (5.1)
+            sqe.opcode = op->write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.fd = op->fd;
+            sqe.off = static_cast<std::uint64_t>(op->offset);
+            sqe.addr = reinterpret_cast<std::uint64_t>(&op->iov);
+            sqe.len = 1;
+            sqe.user_data = reinterpret_cast<std::uint64_t>(op);
+            sqArray_[index] = index;
+            ++tail;
+            ++inFlight_;
+        }
+        std::atomic_ref<unsigned>(*sqTail_).store(tail, std::memory_order_release);
+
+        while (true) {
+            // Everything between the kernel's head and our tail, including entries an interrupted call left behind
+            unsigned toSubmit = tail - std::atomic_ref<unsigned>(*sqHead_).load(std::memory_order_acquire);
+            if (sysIoUringEnter(ringFd_, toSubmit, 1, IORING_ENTER_GETEVENTS) >= 0) {
+                break;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+            }
+        }
+
+        unsigned cqHead = *cqHead_;
+        unsigned cqTail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+        for (; cqHead != cqTail; ++cqHead) {
+            const io_uring_cqe& cqe = cqes_[cqHead & cqMask_];
+            auto* op = reinterpret_cast<Operation*>(cqe.user_data);
+            op->result = cqe.res;
+            ready_.push_back(op->handle);
+            --inFlight_;
+            --pending_;
+        }
+        std::atomic_ref<unsigned>(*cqHead_).store(cqHead, std::memory_order_release);
+    }
+
+    void workerLoop() {
+        while (true) {
+            Operation* op;
+            {
+                std::unique_lock<std::mutex> lock(jobsMutex_);
+                jobsCv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty()) {
+                    return;
+                }
+                op = jobs_.front();
+                jobs_.pop_front();
+            }
+            ssize_t n;
+            do {
+                n = op->write ? pwrite(op->fd, op->iov.iov_base, op->iov.iov_len, op->offset)
+                              : pread(op->fd, op->iov.iov_base, op->iov.iov_len, op->offset);
+            } while (n < 0 && errno == EINTR);
+            op->result = n < 0 ? -errno : n;
+            {
+                std::lock_guard<std::mutex> lock(doneMutex_);
+                done_.push_back(op);
+            }
+            doneCv_.notify_one();
+        }
+    }
+
+    // Waits for finished operations and takes all of them at once
+    void collectCompletions() {
+        std::vector<Operation*> finished;
+        {
+            std::unique_lock<std::mutex> lock(doneMutex_);
+            doneCv_.wait(lock, [this] { return !done_.empty(); });
+            finished.swap(done_);
+        }
+        for (Operation* op : finished) {
+            ready_.push_back(op->handle);
+            --pending_;
+        }
+    }
+
+    std::deque<std::coroutine_handle<>> ready_;
+    std::size_t pending_ = 0;  // Submitted but not yet completed
+
+    // io_uring state
+    int ringFd_ = -1;
+    void* sqRing_ = MAP_FAILED;
+    void* cqRing_ = MAP_FAILED;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqRingBytes_ = 0, cqRingBytes_ = 0, sqesBytes_ = 0;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0, sqEntries_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cqMask_ = 0, cqEntries_ = 0;
+    unsigned inFlight_ = 0;
+    std::deque<Operation*> backlog_;
+
+    // Thread-pool fallback state
+    std::vector<std::thread> workers_;
+    std::mutex jobsMutex_;
+    std::condition_variable jobsCv_;
+    std::deque<Operation*> jobs_;
+    bool stop_ = false;
+    std::mutex doneMutex_;
+    std::condition_variable doneCv_;
+    std::vector<Operation*> done_;
+
+    IoService* previous_ = nullptr;
+    static inline thread_local IoService* current_ = nullptr;
+};
+
+// co_await async_read / async_write: suspends until the transfer completes; returns the number of bytes transferred
+struct IoAwaiter {
+    IoService& io;
+    IoService::Operation op;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        op.handle = h;
+        io.submit(&op);
+    }
+    std::size_t await_resume() const {
+        if (op.result < 0) {
+            throw std::system_error(static_cast<int>(-op.result), std::generic_category(),
+                                    op.write ? "async_write" : "async_read");
+        }
+        return static_cast<std::size_t>(op.result);
+    }
+};
+
+inline IoAwaiter async_read(int fd, std::span<std::byte> buffer, off_t offset) {
+    return {IoService::current(), {false, fd, {buffer.data(), buffer.size()}, offset, 0, {}}};
+}
+
+inline IoAwaiter async_write(int fd, std::span<const std::byte> buffer, off_t offset) {
+    return {IoService::current(),
+            {true, fd, {const_cast<std::byte*>(buffer.data()), buffer.size()}, offset, 0, {}}};
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <coroutine>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "event_loop.h"
+
+/*
+In coroutines.cpp every coroutine calls std::this_thread::sleep_for, which blocks the whole thread while the coroutine
+is "waiting" - nothing else can run, so suspension buys nothing. With an event loop the waiting is done by the loop:
+co_await sleep_for(d) registers a timer and returns control to EventLoop::run(), which resumes the coroutine once the
+deadline has passed. co_await readable(fd) does the same for I/O readiness.
+One thread can then keep thousands of coroutines waiting at the same time.
+*/
+
+// -std=c++20 (Linux)
+
+// Same operations as coroutines.cpp, waiting on the loop instead of blocking the thread
+DetachedTask asyncOperation() {
+    std::cout << "Starting asynchronous operation...\n";
+    co_await sleep_for(std::chrono::seconds(2));  // Simulate delay - the thread stays free
+    std::cout << "Operation completed.\n";
+}
+
+DetachedTask performOperation() {
+    std::cout << "Starting asynchronous operation...\n";
+    co_await sleep_for(std::chrono::seconds(2));
+    std::cout << "Operation completed.\n";
+}
+
+DetachedTask orchestrate() {
+    performOperation();  // Runs until its first co_await, then control comes back here
+    std::cout << "orchestrate doing other work...\n";
+    co_await sleep_for(std::chrono::seconds(1));
+    std::cout << "orchestrate done.\n";
+}
+
+// Many concurrent sleepers on one thread
+DetachedTask sleeper(int& finished) {
+    co_await sleep_for(std::chrono::milliseconds(100));
+    ++finished;
+}
+
+// Waits for data on a pipe without blocking the loop
+DetachedTask pipeReader(int fd) {
+    co_await readable(fd);
+    char buf[64];
+    auto n = read(fd, buf, sizeof(buf));
+    std::cout << "Reader got: " << std::string(buf, n > 0 ? n : 0) << "\n";
+}
+
+DetachedTask pipeWriter(int fd) {
+    co_await sleep_for(std::chrono::milliseconds(50));
+    co_await writable(fd);
+    [[maybe_unused]] auto n = write(fd, "hello", 5);
+}
+
+// Both directions of one socket at once: the loop keeps a separate waiter for each
+DetachedTask socketReader(int fd) {
+    co_await readable(fd);
+    char buf[64];
+    auto n = read(fd, buf, sizeof(buf));
+    std::cout << "Socket reader got: " << std::string(buf, n > 0 ? n : 0) << "\n";
+}
+
+DetachedTask socketWriter(int fd) {
+    co_await writable(fd);
+    [[maybe_unused]] auto n = write(fd, "ping", 4);
+    std::cout << "Socket writer sent ping\n";
+}
+
+int main() {
+    EventLoop loop;
+
+    // Example 1: Both operations and the orchestrator overlap - about 2 seconds in total instead of 5
+    auto start = std::chrono::steady_clock::now();
+    asyncOperation();
+    orchestrate();
+    std::cout << "Main function doing other work...\n";
+    loop.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Example 1 took " << elapsed.count() << " seconds.\n";
+
+    // Example 2: 10'000 coroutines sleeping 100 ms each finish in about 100 ms on one thread
+    int finished = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10'000; ++i) {
+        sleeper(finished);
+    }
+    loop.run();
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << finished << " sleepers finished in " << elapsed.count() << " seconds.\n";
+
+    // Example 3: I/O readiness
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pipeReader(fds[0]);
+        pipeWriter(fds[1]);
+        loop.run();
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    // Example 4: A reader and a writer waiting on the same descriptor
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+        socketReader(sv[0]);  // Suspends: nothing to read yet
+        socketWriter(sv[0]);  // Same descriptor, other direction
+        socketReader(sv[1]);
+        [[maybe_unused]] auto n = write(sv[1], "pong", 4);
+        loop.run();
+        close(sv[0]);
+        close(sv[1]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/*
+A single-threaded event loop for coroutines (Linux: epoll + timerfd).
+Instead of blocking the thread with std::this_thread::sleep_for, a coroutine suspends with co_await sleep_for(d)
+or co_await readable(fd) and the loop resumes it when the deadline passes or the descriptor becomes ready.
+All timers share one timerfd, armed for the earliest deadline in a min-heap, so thousands of sleeping coroutines
+cost one file descriptor and a heap entry each.
+*/
+
+// -std=c++20, Linux only
+
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop() {
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        }
+        timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timerFd_ < 0) {
+            int err = errno;
+            close(epollFd_);
+            throw std::system_error(err, std::generic_category(), "timerfd_create");
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = timerFd_;  // Every registration carries its descriptor; the timer is told apart by its fd
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, timerFd_, &ev) < 0) {
+            int err = errno;
+            close(timerFd_);
+            close(epollFd_);
+            throw std::system_error(err, std::generic_category(), "epoll_ctl (timerfd)");
+        }
+        previous_ = current_;
+        current_ = this;
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    ~EventLoop() {
+        current_ = previous_;
+        close(timerFd_);
+        close(epollFd_);
+    }
+
+    // The loop created most recently on this thread; used by sleep_for() / readable() / writable()
+    static EventLoop& current() { return *current_; }
+
+    // Resumes h on the next iteration of the loop
+    void post(std::coroutine_handle<> h) { ready_.push_back(h); }
+
+    // Runs until there are no ready coroutines, timers or I/O waiters left
+    void run() {
+        std::vector<epoll_event> events(256);
+        while (true) {
+            while (!ready_.empty()) {
+                auto h = ready_.front();
+                ready_.pop_front();
+                h.resume();
+            }
+            if (timers_.empty() && ioWaiters_ == 0) {
+                return;
+            }
+            int n = epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "epoll_wait");
+            }
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.fd == timerFd_) {
+                    std::uint64_t expirations;
+                    [[maybe_unused]] auto r = read(timerFd_, &expirations, sizeof(expirations));
+                    fireTimers();
+                } else {
+                    dispatchFd(events[i].data.fd, events[i].events);
+                }
+            }
+        }
+    }
+
+    void addTimer(Clock::time_point deadline, std::coroutine_handle<> h) {
+        bool earliest = timers_.empty() || deadline < timers_.top().deadline;
+        timers_.push({deadline, nextTimerId_++, h});
+        if (earliest) {
+            armTimer();
+        }
+    }
+
+    struct FdWaiter {
+        std::coroutine_handle<> handle;
+        std::uint32_t events = 0;   // What the waiter asked for
+        std::uint32_t revents = 0;  // What epoll reported
+    };
+
+    // One-shot readiness wait. A descriptor can have one reader (EPOLLIN) and one writer (EPOLLOUT) waiting at the
+    // same time; epoll watches the union of their events. The descriptor stays registered (disarmed) afterwards and
+    // is re-armed by the next wait.
+    void waitFd(int fd, std::uint32_t events, FdWaiter* waiter) {
+        FdRecord& record = fds_[fd];
+        FdWaiter*& slot = (events & EPOLLOUT) ? record.writer : record.reader;
+        if (slot != nullptr) {
+            throw std::logic_error("EventLoop::waitFd: descriptor already has a waiter in this direction");
+        }
+        waiter->events = events;
+        slot = waiter;
+        try {
+            armFd(fd, record);
+        } catch (...) {
+            slot = nullptr;
+            throw;
+        }
+        ++ioWaiters_;
+    }
+
+private:
+    struct FdRecord {
+        FdWaiter* reader = nullptr;
+        FdWaiter* writer = nullptr;
+    };
+
+    void armFd(int fd, const FdRecord& record) {
+        epoll_event ev{};
+        ev.events = (record.reader ? record.reader->events : 0) | (record.writer ? record.writer->events : 0) |
+                    EPOLLONESHOT;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+            if (errno != ENOENT || epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+            }
+        }
+    }
+
+    // Resumes whichever waiters the events are for; re-arms the descriptor for a waiter that is still pending
+    void dispatchFd(int fd, std::uint32_t revents) {
+        auto it = fds_.find(fd);
+        if (it == fds_.end()) {
+            return;
+        }
+        FdRecord& record = it->second;
+        const std::uint32_t always = EPOLLERR | EPOLLHUP;  // Reported to both sides
+        for (FdWaiter** slot : {&record.reader, &record.writer}) {
+            FdWaiter* waiter = *slot;
+            if (waiter != nullptr && (revents & (waiter->events | always))) {
+                waiter->revents = revents;
+                *slot = nullptr;
+                --ioWaiters_;
+                ready_.push_back(waiter->handle);
+            }
+        }
+        if (record.reader || record.writer) {
+            armFd(fd, record);  // EPOLLONESHOT disarmed the descriptor for the other side as well
+        } else {
+            fds_.erase(it);
+        }
+    }
+
+    struct Timer {
+        Clock::time_point deadline;
+        std::uint64_t id;  // Tie-breaker: equal deadlines fire in the order they were added
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : id > other.id;
+        }
+    };
+
+    void fireTimers() {
+        auto now = Clock::now();
+        while (!timers_.empty() && timers_.top().deadline <= now) {
+            ready_.push_back(timers_.top().handle);
+            timers_.pop();
+        }
+        if (!timers_.empty()) {
+            armTimer();
+        }
+    }
+
+    void armTimer() {
+        // steady_clock is CLOCK_MONOTONIC on Linux, so the deadline can be used as an absolute expiry
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timers_.top().deadline.time_since_epoch());
+        itimerspec spec{};
+        spec.it_value.tv_sec = std::max<long long>(0, ns.count() / 1'000'000'000);
+        spec.it_value.tv_nsec = ns.count() % 1'000'000'000;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;  // All-zero would disarm the timer
+        }
+        timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    int epollFd_ = -1;
+    int timerFd_ = -1;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    std::uint64_t nextTimerId_ = 0;
+    std::unordered_map<int, FdRecord> fds_;  // Descriptors with a pending waiter
+    std::size_t ioWaiters_ = 0;
+    EventLoop* previous_ = nullptr;
+    static inline thread_local EventLoop* current_ = nullptr;
+};
+
+// co_await sleep_for(d): suspends the coroutine without blocking the thread
+struct SleepAwaiter {
+    EventLoop& loop;
+    EventLoop::Clock::time_point deadline;
+
+    bool await_ready() const { return deadline <= EventLoop::Clock::now(); }
+    void await_suspend(std::coroutine_handle<> h) { loop.addTimer(deadline, h); }
+    void await_resume() const noexcept {}
+};
+
+template <class Rep, class Period>
+SleepAwaiter sleep_for(std::chrono::duration<Rep, Period> d) {
+    return {EventLoop::current(),
+            EventLoop::Clock::now() + std::chrono::duration_cast<EventLoop::Clock::duration>(d)};
+}
+
+// co_await readable(fd) / writable(fd): resumes when epoll reports the descriptor ready; returns the epoll events
+struct FdAwaiter {
+    EventLoop& loop;
+    int fd;
+    std::uint32_t events;
+    EventLoop::FdWaiter waiter{};
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        waiter.handle = h;
+        loop.waitFd(fd, events, &waiter);
+    }
+    std::uint32_t await_resume() const noexcept { return waiter.revents; }
+};
+
+inline FdAwaiter readable(int fd) { return {EventLoop::current(), fd, EPOLLIN}; }
+inline FdAwaiter writable(int fd) { return {EventLoop::current(), fd, EPOLLOUT}; }
+
+// Fire-and-forget coroutine: starts immediately, runs until its first co_await and frees itself when it finishes.
+// Whatever it awaits (timers, descriptors) keeps EventLoop::run() going until it is done.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/*
+Recycling allocator for coroutine frames.
+Every call to a coroutine allocates its frame with operator new, and for short-lived coroutines that allocation is
+most of the cost. Coroutine frames come in very few sizes (one per coroutine function), so they recycle well:
+- Frame sizes are rounded up to 64-byte size classes (up to 1 KiB; larger frames use the global operator new).
+- Each thread keeps one intrusive free list per size class. Allocating pops a block, freeing pushes it back: no locks,
+  no atomics, no trip into malloc in the steady state.
+- A frame freed on another thread than the one that allocated it simply joins the freeing thread's list.
+- Each list caches at most kMaxCachedPerClass blocks; beyond that blocks go back to the global heap, and a thread's
+  cached blocks are released when the thread exits.
+A promise_type opts in by inheriting PooledFrameAllocator, whose operator new/delete the compiler then uses for the
+frame.
+*/
+
+// -std=c++20
+
+class FramePool {
+public:
+    static constexpr std::size_t kGranularity = 64;
+    static constexpr std::size_t kClasses = 16;  // 64 .. 1024 bytes
+    static constexpr std::size_t kMaxPooledSize = kGranularity * kClasses;
+    static constexpr std::uint32_t kMaxCachedPerClass = 4096;
+
+    static void* allocate(std::size_t size) {
+        if (size > kMaxPooledSize || cacheDestroyed()) {
+            return ::operator new(size);
+        }
+        std::size_t index = classIndex(size);
+        Cache& cache = local();
+        if (FreeBlock* block = cache.head[index]) {
+            cache.head[index] = block->next;
+            --cache.count[index];
+            return block;
+        }
+        return ::operator new((index + 1) * kGranularity);
+    }
+
+    static void deallocate(void* p, std::size_t size) noexcept {
+        if (size > kMaxPooledSize) {
+            ::operator delete(p);
+            return;
+        }
+        std::size_t index = classIndex(size);
+        if (cacheDestroyed() || local().count[index] >= kMaxCachedPerClass) {
+            ::operator delete(p);
+            return;
+        }
+        Cache& cache = local();
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = cache.head[index];
+        cache.head[index] = block;
+        ++cache.count[index];
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Cache {
+        FreeBlock* head[kClasses] = {};
+        std::uint32_t count[kClasses] = {};
+
+        ~Cache() {
+            for (FreeBlock* block : head) {
+                while (block) {
+                    FreeBlock* next = block->next;
+                    ::operator delete(block);
+                    block = next;
+                }
+            }
+            cacheDestroyed() = true;  // Frames freed later during thread exit bypass the cache
+        }
+    };
+
+    static std::size_t classIndex(std::size_t size) { return size == 0 ? 0 : (size - 1) / kGranularity; }
+
+    static Cache& local() {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    static bool& cacheDestroyed() {
+        static thread_local bool destroyed = false;  // Trivially destructible, safe to read during thread exit
+        return destroyed;
+    }
+};
+
+// Inherit from this in a promise_type to allocate its coroutine frames from FramePool
+struct PooledFrameAllocator {
+    static void* operator new(std::size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void* p, std::size_t size) noexcept { FramePool::deallocate(p, size); }
+};
+
+// Inherit from this instead to keep the global operator new (used as the baseline in benchmarks)
+struct DefaultFrameAllocator {};
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <ranges>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+
+#include "generator.h"
+
+/*
+The Task in coroutines.cpp can suspend and resume but has no way to hand values to its caller. Generator<T> from
+generator.h adds co_yield: each co_yield suspends the coroutine and makes one value available to the consumer.
+Generators are lazy, so they express streaming scans - lines of a file, records parsed from those lines - as a
+pipeline that processes one element at a time and never builds an intermediate std::vector.
+*/
+
+// -std=c++20
+
+// Infinite sequence; the consumer decides how much of it to take
+Generator<std::uint64_t> fibonacci() {
+    std::uint64_t a = 0, b = 1;
+    while (true) {
+        co_yield a;
+        a = std::exchange(b, a + b);
+    }
+}
+
+// Yields every line of a stream; the same std::string buffer is reused for every line
+Generator<const std::string&> lines(std::istream& in) {
+    std::string line;
+    while (std::getline(in, line)) {
+        co_yield line;
+    }
+}
+
+struct Record {
+    std::string_view name;
+    int value;
+};
+
+// Parses "name,value" lines; the string_view points into the line buffer and is valid until the next element
+Generator<Record> records(std::istream& in) {
+    for (const std::string& line : lines(in)) {
+        auto comma = line.find(',');
+        if (comma == std::string::npos) {
+            throw std::runtime_error("malformed line: " + line);
+        }
+        co_yield Record{std::string_view(line).substr(0, comma), std::stoi(line.substr(comma + 1))};
+    }
+}
+
+int main() {
+    // Example 1: Infinite generator + std::views
+    std::cout << "Even Fibonacci numbers: ";
+    for (auto f : fibonacci() | std::views::filter([](std::uint64_t x) { return x % 2 == 0; }) | std::views::take(8)) {
+        std::cout << f << " ";
+    }
+    std::cout << "\n";
+
+    // Example 2: Streaming scan over a file, one record at a time
+    const char* path = "generator_example.csv";
+    {
+        std::ofstream out(path);
+        out << "apples,3\nbananas,12\ncherries,7\ndates,20\n";
+    }
+    std::ifstream file(path);
+    int total = 0;
+    for (const Record& r : records(file) | std::views::filter([](const Record& r) { return r.value > 5; })) {
+        std::cout << r.name << " = " << r.value << "\n";
+        total += r.value;
+    }
+    std::cout << "Total of values > 5: " << total << "\n";
+    std::remove(path);
+
+    // Example 3: Errors in the producer surface in the consumer's loop
+    std::istringstream bad("ok,1\nbroken line\n");
+    try {
+        for (const Record& r : records(bad)) {
+            std::cout << "Parsed " << r.name << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Caught: " << e.what() << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "frame_pool.h"
+
+/*
+Generator<T>: a lazy sequence produced by a coroutine with co_yield.
+- The body runs only when the consumer asks for the next element (begin() / operator++), and stops at each co_yield.
+- No allocation per element: co_yield stores the address of the yielded object in the promise and the iterator
+  reads it through that pointer. The object stays alive while the coroutine is suspended at the co_yield.
+- The only allocation is the coroutine frame itself, which comes from FramePool (frame_pool.h).
+- Generator is an input_range and a view, so it composes with range-for and std::views (filter, transform, take...).
+- An exception thrown in the body propagates out of begin() / operator++ in the consumer.
+*/
+
+// -std=c++20
+
+template <class T>
+class [[nodiscard]] Generator : public std::ranges::view_base {
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    struct promise_type : PooledFrameAllocator {
+        pointer current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() noexcept {
+            return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(std::remove_reference_t<reference>& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        // Yielding a temporary: it lives until the coroutine resumes, which is all the consumer needs
+        std::suspend_always yield_value(std::remove_reference_t<reference>&& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        // Generators cannot co_await
+        template <class U>
+        std::suspend_never await_transform(U&&) = delete;
+
+        void rethrowIfFailed() const {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = Generator::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(handle_type h) : coro_(h) {}
+
+        reference operator*() const { return static_cast<reference>(*coro_.promise().current); }
+        pointer operator->() const { return coro_.promise().current; }
+
+        iterator& operator++() {
+            coro_.resume();
+            if (coro_.done()) {
+                coro_.promise().rethrowIfFailed();
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) { return !it.coro_ || it.coro_.done(); }
+
+    private:
+        handle_type coro_;
+    };
+
+    Generator() = default;
+    explicit Generator(handle_type h) : coro_(h) {}
+    Generator(Generator&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (coro_) {
+                coro_.destroy();
+            }
+            coro_ = std::exchange(other.coro_, {});
+        }
+        return *this;
+    }
+    ~Generator() {
+        if (coro_) {
+            coro_.destroy();
+        }
+    }
+
+    // Starts the body and runs it to the first co_yield; call once (it is an input range)
+    iterator begin() {
+        if (coro_) {
+            coro_.resume();
+            if (coro_.done()) {
+                coro_.promise().rethrowIfFailed();
+            }
+        }
+        return iterator{coro_};
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    handle_type coro_;
+};
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+
+#include "task.h"
+
+/*
+In coroutines.cpp, orchestrate() creates performOperation() and then drives it by hand with operation.resume(); the
+Task type can only return_void, so the child has no way to hand a result (or an error) back.
+Task<T> from task.h is awaitable instead:
+- co_await performOperation() starts the child, suspends the parent, and resumes the parent when the child is done.
+- The child's co_return value becomes the value of the co_await expression; its exceptions are rethrown there.
+- Resumption uses symmetric transfer, so a chain of 100'000 nested awaits runs in constant stack space.
+  (GCC only emits the required tail calls with optimization on and without sanitizers; build with -O1 or higher.)
+*/
+
+// -std=c++20 -O2
+
+// Coroutine that produces a value for its awaiter
+Task<int> performOperation() {
+    std::cout << "Starting operation...\n";
+    co_return 42;
+}
+
+// Coroutine that fails; the exception surfaces at the co_await in the caller
+Task<int> failingOperation() {
+    throw std::runtime_error("operation failed");
+    co_return 0;
+}
+
+Task<std::string> orchestrate() {
+    std::cout << "orchestrate started.\n";
+    int result = co_await performOperation();  // No manual resume()
+    std::cout << "Operation returned " << result << "\n";
+
+    try {
+        co_await failingOperation();
+    } catch (const std::exception& e) {
+        std::cout << "Caught: " << e.what() << "\n";
+    }
+    co_return "orchestrate finished";
+}
+
+// Each level awaits the next; without symmetric transfer this would need depth stack frames
+Task<long long> deepChain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    long long below = co_await deepChain(depth - 1);
+    co_return below + depth;
+}
+
+int main() {
+    // Example 1: Lazy start - nothing runs until the Task is awaited
+    Task<std::string> task = orchestrate();
+    std::cout << "Task created, not started yet.\n";
+    std::cout << syncWait(std::move(task)) << "\n";
+
+    // Example 2: Deep await chain
+    std::cout << "Sum of 1..100000 via nested awaits: " << syncWait(deepChain(100'000)) << "\n";
+
+    // Example 3: Exceptions propagate through syncWait too
+    try {
+        syncWait(failingOperation());
+    } catch (const std::exception& e) {
+        std::cout << "syncWait rethrew: " << e.what() << "\n";
+    }
+
+    return 0;
+}
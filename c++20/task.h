@@ -0,0 +1,211 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "frame_pool.h"
+
+/*
+Task<T>: a lazily started, awaitable coroutine that produces a T (or void).
+- Lazy: calling a Task-returning function only creates the frame; the body starts when the Task is co_awaited.
+- Continuations: co_await stores the awaiting coroutine in the child's promise; when the child finishes, its
+  final_suspend resumes that continuation.
+- Symmetric transfer: await_suspend / final_suspend return the coroutine_handle to run next instead of calling
+  resume() on it, so the compiler turns "start child" and "resume parent" into tail calls. Arbitrarily deep chains of
+  co_await do not grow the stack.
+- Results and exceptions: co_return value is handed to the awaiter; an exception escaping the body is captured and
+  rethrown from co_await.
+- Frame allocation: frames come from the per-thread FramePool (frame_pool.h); pass DefaultFrameAllocator as the
+  second template argument to use the global operator new instead.
+syncWait(task) starts a Task from ordinary code and blocks until it finishes.
+*/
+
+// -std=c++20
+
+template <class T = void, class FrameAllocator = PooledFrameAllocator>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    // Resumes whoever co_awaited us; noop_coroutine() when nobody did (returning it simply returns to the resumer)
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <class Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    void rethrowIfFailed() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+};
+
+template <class T, class FrameAllocator>
+struct TaskPromise : TaskPromiseBase, FrameAllocator {
+    Task<T, FrameAllocator> get_return_object() noexcept;
+
+    template <class U = T>
+    void return_value(U&& value) {
+        result.emplace(std::forward<U>(value));
+    }
+
+    T take() {
+        rethrowIfFailed();
+        return std::move(*result);
+    }
+
+    std::optional<T> result;
+};
+
+template <class FrameAllocator>
+struct TaskPromise<void, FrameAllocator> : TaskPromiseBase, FrameAllocator {
+    Task<void, FrameAllocator> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void take() const { rethrowIfFailed(); }
+};
+
+}  // namespace detail
+
+template <class T, class FrameAllocator>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T, FrameAllocator>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(handle_type h) : coro_(h) {}
+    Task(Task&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (coro_) {
+                coro_.destroy();
+            }
+            coro_ = std::exchange(other.coro_, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (coro_) {
+            coro_.destroy();
+        }
+    }
+
+    bool done() const { return !coro_ || coro_.done(); }
+    handle_type handle() const { return coro_; }
+
+    struct Awaiter {
+        handle_type coro;
+
+        bool await_ready() const noexcept { return !coro || coro.done(); }
+        // Symmetric transfer: remember who to resume, then jump straight into the child
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            coro.promise().continuation = awaiting;
+            return coro;
+        }
+        T await_resume() { return coro.promise().take(); }
+    };
+
+    Awaiter operator co_await() const& noexcept { return Awaiter{coro_}; }
+    Awaiter operator co_await() const&& noexcept { return Awaiter{coro_}; }
+
+    // Like co_await, but only waits for completion; the result (or exception) stays in the Task
+    struct ReadyAwaiter : Awaiter {
+        void await_resume() const noexcept {}
+    };
+    ReadyAwaiter whenReady() const noexcept { return ReadyAwaiter{{coro_}}; }
+
+private:
+    handle_type coro_;
+};
+
+namespace detail {
+
+template <class T, class FrameAllocator>
+Task<T, FrameAllocator> TaskPromise<T, FrameAllocator>::get_return_object() noexcept {
+    return Task<T, FrameAllocator>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+template <class FrameAllocator>
+Task<void, FrameAllocator> TaskPromise<void, FrameAllocator>::get_return_object() noexcept {
+    return Task<void, FrameAllocator>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+// Completion flag for syncWait(). notify happens under the lock, so the waiter cannot return and destroy the
+// signal while the completing thread is still touching it.
+struct SyncSignal {
+    std::mutex m;
+    std::condition_variable cv;
+    bool done = false;
+
+    void set() {
+        std::lock_guard<std::mutex> lock(m);
+        done = true;
+        cv.notify_one();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [this] { return done; });
+    }
+};
+
+// Wrapper coroutine that sets a SyncSignal when the awaited Task completes (on whatever thread)
+struct SyncWaitTask {
+    struct promise_type {
+        SyncSignal* signal = nullptr;
+
+        SyncWaitTask get_return_object() noexcept {
+            return SyncWaitTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        auto final_suspend() const noexcept {
+            struct Notify {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+                    h.promise().signal->set();
+                }
+                void await_resume() const noexcept {}
+            };
+            return Notify{};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }  // The awaited Task captures exceptions
+    };
+
+    std::coroutine_handle<promise_type> coro;
+};
+
+// Runs the Task and waits for it without taking its result; syncWait() takes it (or its exception) afterwards
+template <class T, class FrameAllocator>
+SyncWaitTask awaitCompletion(const Task<T, FrameAllocator>& task) {
+    co_await task.whenReady();
+}
+
+}  // namespace detail
+
+// Runs task to completion from non-coroutine code and returns its result (or rethrows its exception)
+template <class T, class FrameAllocator>
+T syncWait(Task<T, FrameAllocator>&& task) {
+    detail::SyncSignal signal;
+    detail::SyncWaitTask waiter = detail::awaitCompletion(task);
+    waiter.coro.promise().signal = &signal;
+    waiter.coro.resume();
+    signal.wait();
+    waiter.coro.destroy();
+    return task.handle().promise().take();
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <chrono>
+#include <latch>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+/*
+The Task in coroutines.cpp always continues on whichever thread happens to call resume(). With ThreadPool from
+thread_pool.h a coroutine picks its thread instead: co_await schedule_on(pool) suspends it and a pool worker
+resumes it. Ready coroutines are spread over per-worker run queues and idle workers steal from busy ones.
+The benchmark measures coroutine context switches (suspend + resume on a worker) per second as the number of worker
+threads grows.
+*/
+
+// -std=c++20 -O2 -pthread
+
+std::string threadId() {
+    std::ostringstream os;
+    os << std::this_thread::get_id();
+    return os.str();
+}
+
+Task<int> computeOnPool(ThreadPool& pool) {
+    std::cout << "Started on thread " << threadId() << "\n";
+    co_await schedule_on(pool);  // Hop onto a worker
+    std::cout << "Continuing on pool thread " << threadId() << "\n";
+    co_return 6 * 7;
+}
+
+// Reschedules itself hops times, then counts down the latch
+Task<void> hopper(ThreadPool& pool, int hops, std::latch& done) {
+    for (int i = 0; i < hops; ++i) {
+        co_await pool.schedule();
+    }
+    done.count_down();
+}
+
+int main() {
+    // Example 1: Moving a coroutine onto the pool and getting its result back
+    {
+        ThreadPool pool(2);
+        std::cout << "Main thread " << threadId() << "\n";
+        int result = syncWait(computeOnPool(pool));
+        std::cout << "Result: " << result << "\n";
+    }
+
+    // Example 2: Context switches per second as workers scale
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    constexpr int hopsPerCoroutine = 100'000;
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);  // Always finish with every core
+
+    for (unsigned threads : threadCounts) {
+        const int coroutines = static_cast<int>(threads) * 4;  // More runnable coroutines than workers
+        std::latch done(coroutines);  // Declared first: the pool joins its workers before the latch goes away
+        ThreadPool pool(threads);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < coroutines; ++i) {
+            pool.spawn(hopper(pool, hopsPerCoroutine, done));
+        }
+        done.wait();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double switches = static_cast<double>(coroutines) * hopsPerCoroutine;
+        std::cout << threads << " worker(s): " << switches / elapsed.count() / 1e6 << " M switches/s\n";
+    }
+
+    return 0;
+}
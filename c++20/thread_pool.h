@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "task.h"
+
+/*
+A multi-threaded executor for coroutines.
+- co_await pool.schedule() (or co_await schedule_on(pool)) suspends the coroutine and resumes it on one of the
+  pool's worker threads.
+- Every worker has its own run queue. A coroutine scheduled from a worker goes to that worker's queue (it is likely
+  still warm in that core's cache); one scheduled from outside is spread round-robin over the queues.
+- A worker whose queue is empty steals from the other end of a randomly chosen victim's queue before going to sleep,
+  so ready coroutines end up on whichever cores are idle.
+- pool.spawn(task) starts a Task<void> on the pool without waiting for it.
+Each queue has its own small mutex, which is uncontended unless a thief is stealing from it.
+*/
+
+// -std=c++20 -pthread
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()))
+        : queues_(threads) {
+        for (auto& q : queues_) {
+            q = std::make_unique<RunQueue>();
+        }
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_.store(true);
+        }
+        sleepCv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Makes h runnable on this pool
+    void enqueue(std::coroutine_handle<> h) {
+        std::size_t index = currentPool() == this
+                                ? static_cast<std::size_t>(currentIndex())
+                                : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        queues_[index]->push(h);
+        // Pairs with the fence in workerLoop(): either we see the sleeper or it sees the new item
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            sleepCv_.notify_one();
+        }
+    }
+
+    struct ScheduleAwaiter {
+        ThreadPool& pool;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) const { pool.enqueue(h); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await pool.schedule(): continue on a worker of this pool (also used to yield to other coroutines)
+    ScheduleAwaiter schedule() { return ScheduleAwaiter{*this}; }
+
+    // Fire-and-forget: runs task on the pool; an exception escaping it terminates the program
+    void spawn(Task<void> task) { runDetached(*this, std::move(task)); }
+
+private:
+    class RunQueue {
+    public:
+        void push(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(m_);
+            items_.push_back(h);
+        }
+        // Owner takes the oldest item (FIFO keeps yielding coroutines fair)
+        std::coroutine_handle<> pop() {
+            std::lock_guard<std::mutex> lock(m_);
+            if (items_.empty()) {
+                return {};
+            }
+            auto h = items_.front();
+            items_.pop_front();
+            return h;
+        }
+        // Thieves take from the other end to stay away from the owner
+        std::coroutine_handle<> steal() {
+            std::unique_lock<std::mutex> lock(m_, std::try_to_lock);
+            if (!lock || items_.empty()) {
+                return {};
+            }
+            auto h = items_.back();
+            items_.pop_back();
+            return h;
+        }
+        bool empty() {
+            std::lock_guard<std::mutex> lock(m_);
+            return items_.empty();
+        }
+
+    private:
+        std::mutex m_;
+        std::deque<std::coroutine_handle<>> items_;
+    };
+
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    static Detached runDetached(ThreadPool& pool, Task<void> task) {
+        co_await pool.schedule();
+        co_await task;
+    }
+
+    static ThreadPool*& currentPool() {
+        static thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& currentIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    std::coroutine_handle<> findWork(unsigned self) {
+        if (auto h = queues_[self]->pop()) {
+            return h;
+        }
+        static thread_local std::uint64_t rng = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        std::size_t n = queues_.size();
+        std::size_t start = rng % n;
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t victim = (start + k) % n;
+            if (victim != self) {
+                if (auto h = queues_[victim]->steal()) {
+                    return h;
+                }
+            }
+        }
+        return {};
+    }
+
+    bool anyWork() {
+        for (auto& q : queues_) {
+            if (!q->empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned index) {
+        currentPool() = this;
+        currentIndex() = static_cast<int>(index);
+        int idleRounds = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (auto h = findWork(index)) {
+                h.resume();
+                idleRounds = 0;
+                continue;
+            }
+            if (++idleRounds < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!anyWork() && !stop_.load(std::memory_order_acquire)) {
+                sleepCv_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            idleRounds = 0;
+        }
+    }
+
+    std::vector<std::unique_ptr<RunQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> next_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+// co_await schedule_on(pool): moves the current coroutine onto one of pool's workers
+inline ThreadPool::ScheduleAwaiter schedule_on(ThreadPool& pool) {
+    return pool.schedule();
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <chrono>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+#include "when_all_any.h"
+
+/*
+Awaiting Tasks one after another (co_await a; co_await b;) runs them one after another. when_all and when_any from
+when_all_any.h start several Tasks at once and resume the awaiting coroutine when all of them, or the first of them,
+have finished. Combined with ThreadPool each child runs on its own worker, so a fan-out of N one-second jobs takes
+about one second instead of N.
+*/
+
+// -std=c++20 -O2 -pthread
+
+using Clock = std::chrono::steady_clock;
+
+// Stands in for a blocking call (a request to another service, a disk read...) that runs on a pool worker
+Task<int> fetch(ThreadPool& pool, int id, std::chrono::milliseconds latency) {
+    co_await schedule_on(pool);
+    std::this_thread::sleep_for(latency);
+    co_return id * 10;
+}
+
+// A replica for when_any: like fetch, but reports when it is done, so main() knows when the losers have finished
+Task<int> replica(ThreadPool& pool, int id, std::chrono::milliseconds latency, std::latch& finished) {
+    co_await schedule_on(pool);
+    std::this_thread::sleep_for(latency);
+    finished.count_down();
+    co_return id * 10;
+}
+
+Task<std::string> fetchName(ThreadPool& pool) {
+    co_await schedule_on(pool);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    co_return "widget";
+}
+
+Task<void> failing(ThreadPool& pool) {
+    co_await schedule_on(pool);
+    throw std::runtime_error("backend unavailable");
+}
+
+Task<void> demo(ThreadPool& pool, std::latch& replicasFinished) {
+    using namespace std::chrono_literals;
+
+    // Example 1: Heterogeneous fan-out; results come back as a tuple in argument order
+    auto start = Clock::now();
+    auto [price, name] = co_await when_all(fetch(pool, 4, 100ms), fetchName(pool));
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    std::cout << "when_all(price, name) = " << price << ", " << name << " in " << elapsed.count() << " ms\n";
+
+    // Example 2: Range overload; total time is close to the slowest child, not the sum
+    std::vector<Task<int>> requests;
+    for (int i = 1; i <= 4; ++i) {
+        requests.push_back(fetch(pool, i, std::chrono::milliseconds(50 * i)));
+    }
+    start = Clock::now();
+    std::vector<int> results = co_await when_all(std::move(requests));
+    elapsed = Clock::now() - start;
+    std::cout << "when_all(4 requests) =";
+    for (int r : results) {
+        std::cout << " " << r;
+    }
+    std::cout << " in " << elapsed.count() << " ms (sequential would take 500 ms)\n";
+
+    // Example 3: First answer wins; the slower replicas finish in the background
+    start = Clock::now();
+    auto first = co_await when_any(replica(pool, 1, 300ms, replicasFinished), replica(pool, 2, 50ms, replicasFinished),
+                                   replica(pool, 3, 200ms, replicasFinished));
+    elapsed = Clock::now() - start;
+    std::cout << "when_any(3 replicas): replica " << first.index << " answered " << first.value << " in "
+              << elapsed.count() << " ms\n";
+
+    // Example 4: A failing child's exception surfaces in the awaiting coroutine
+    try {
+        co_await when_all(fetch(pool, 5, 10ms), failing(pool));
+    } catch (const std::exception& e) {
+        std::cout << "when_all rethrew: " << e.what() << "\n";
+    }
+}
+
+int main() {
+    std::latch replicasFinished(3);  // Declared before the pool: the replicas still use it while the pool shuts down
+    ThreadPool pool(4);
+    syncWait(demo(pool, replicasFinished));
+    // The losers of Example 3 are still running on the pool; the pool must not shut down before they are done
+    replicasFinished.wait();
+    return 0;
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "task.h"
+
+/*
+when_all / when_any: await several Tasks that run concurrently.
+- Both start every child from the awaiting coroutine's await_suspend. A child runs until its first suspension point
+  (for example co_await schedule_on(pool) or sleep_for), so children that wait on a pool or a timer overlap and the
+  whole fan-out takes as long as the slowest (when_all) or fastest (when_any) child.
+- Completion is tracked with one atomic counter, no mutex. The counter starts at children + 1; the extra count
+  belongs to the awaiting coroutine and is only released once every child has been started, so the parent is resumed
+  exactly once: by the last child to finish, or directly by await_suspend when every child finished synchronously.
+- when_all(a, b, c) returns a std::tuple of the results (std::monostate for Task<void>); when_all(vector) returns
+  a std::vector (or nothing for Task<void>). The first failing child, in argument order, has its exception rethrown.
+- when_any(vector) / when_any(a, b, ...) returns {index, result} of the first child to finish (just the index for
+  Task<void>). The others keep running to completion in the background - coroutines cannot be cancelled from the
+  outside - and their state is freed by whichever finishes last.
+*/
+
+// -std=c++20
+
+namespace detail {
+
+template <class T>
+using NonVoid = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <class T, class A>
+NonVoid<T> takeResult(const Task<T, A>& task) {
+    if constexpr (std::is_void_v<T>) {
+        task.handle().promise().take();
+        return {};
+    } else {
+        return task.handle().promise().take();
+    }
+}
+
+// Receives the completion of child number index and returns the coroutine to run next
+struct CompletionSink {
+    virtual std::coroutine_handle<> onChildComplete(std::size_t index) noexcept = 0;
+
+protected:
+    ~CompletionSink() = default;
+};
+
+// Wrapper coroutine around one child Task: runs it, then reports to the sink from final_suspend
+class FanOutChild {
+public:
+    struct promise_type {
+        CompletionSink* sink = nullptr;
+        std::size_t index = 0;
+
+        FanOutChild get_return_object() noexcept {
+            return FanOutChild{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        auto final_suspend() const noexcept {
+            struct Report {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+                    // May destroy this very frame (when_any), so nothing may touch h afterwards
+                    auto& p = h.promise();
+                    return p.sink->onChildComplete(p.index);
+                }
+                void await_resume() const noexcept {}
+            };
+            return Report{};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }  // The child Task captures its own exceptions
+    };
+
+    FanOutChild() = default;
+    explicit FanOutChild(std::coroutine_handle<promise_type> h) : coro_(h) {}
+    FanOutChild(FanOutChild&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+    FanOutChild& operator=(FanOutChild&& other) noexcept {
+        if (this != &other) {
+            if (coro_) {
+                coro_.destroy();
+            }
+            coro_ = std::exchange(other.coro_, {});
+        }
+        return *this;
+    }
+    ~FanOutChild() {
+        if (coro_) {
+            coro_.destroy();
+        }
+    }
+
+    void start(CompletionSink& sink, std::size_t index) {
+        coro_.promise().sink = &sink;
+        coro_.promise().index = index;
+        coro_.resume();
+    }
+
+private:
+    std::coroutine_handle<promise_type> coro_;
+};
+
+template <class T, class A>
+FanOutChild makeChild(const Task<T, A>& task) {
+    co_await task.whenReady();
+}
+
+// Atomic countdown shared by all children of one when_all
+class WhenAllCounter final : public CompletionSink {
+public:
+    explicit WhenAllCounter(std::size_t children) : count_(children + 1) {}
+
+    std::coroutine_handle<> onChildComplete(std::size_t) noexcept override {
+        if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            return parent_;  // Last one out resumes the parent (symmetric transfer)
+        }
+        return std::noop_coroutine();
+    }
+
+    // Called by the parent after starting every child; false means all of them already finished
+    bool suspendParent(std::coroutine_handle<> parent) noexcept {
+        parent_ = parent;
+        return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+private:
+    std::atomic<std::size_t> count_;
+    std::coroutine_handle<> parent_;
+};
+
+template <class Children>
+struct WhenAllAwaiter {
+    Children& children;
+    WhenAllCounter counter;
+
+    explicit WhenAllAwaiter(Children& c) : children(c), counter(std::size(c)) {}
+
+    bool await_ready() const noexcept { return std::size(children) == 0; }
+    bool await_suspend(std::coroutine_handle<> parent) {
+        std::size_t index = 0;
+        for (auto& child : children) {
+            child.start(counter, index++);
+        }
+        return counter.suspendParent(parent);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Heap state of one when_any; outlives the awaiting coroutine when losers are still running
+template <class T, class A>
+class WhenAnyState final : public CompletionSink {
+public:
+    static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+    explicit WhenAnyState(std::vector<Task<T, A>> tasks)
+        : tasks_(std::move(tasks)), refs_(tasks_.size() + 1) {
+        children_.reserve(tasks_.size());
+        for (const auto& task : tasks_) {
+            children_.push_back(makeChild(task));
+        }
+    }
+
+    std::coroutine_handle<> onChildComplete(std::size_t index) noexcept override {
+        std::coroutine_handle<> next = std::noop_coroutine();
+        std::size_t expected = kNone;
+        if (winner_.compare_exchange_strong(expected, index, std::memory_order_acq_rel)) {
+            if (gate_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                next = parent_;
+            }
+        }
+        release();  // May delete this (and the calling child's frame)
+        return next;
+    }
+
+    // Starts every child; returns false if the parent must not suspend because a child already won
+    bool start(std::coroutine_handle<> parent) {
+        parent_ = parent;
+        for (std::size_t i = 0; i < children_.size(); ++i) {
+            children_[i].start(*this, i);
+        }
+        return gate_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+    std::size_t winner() const { return winner_.load(std::memory_order_acquire); }
+    const Task<T, A>& task(std::size_t i) const { return tasks_[i]; }
+
+    void release() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+private:
+    std::vector<Task<T, A>> tasks_;
+    std::vector<FanOutChild> children_;
+    std::atomic<std::size_t> refs_;       // One per child plus one for the awaiting coroutine
+    std::atomic<std::size_t> winner_{kNone};
+    std::atomic<int> gate_{2};            // Winner and parent; whoever arrives second resumes the parent
+    std::coroutine_handle<> parent_;
+};
+
+template <class T, class A>
+struct WhenAnyAwaiter {
+    WhenAnyState<T, A>* state;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> parent) { return state->start(parent); }
+    void await_resume() const noexcept {}
+};
+
+// Drops the awaiting coroutine's reference even if taking the winner's result throws
+template <class T, class A>
+struct WhenAnyRef {
+    WhenAnyState<T, A>* state;
+    ~WhenAnyRef() { state->release(); }
+};
+
+}  // namespace detail
+
+template <class T>
+struct WhenAnyResult {
+    std::size_t index;
+    T value;
+};
+
+// Variadic when_all: tuple of results in argument order
+template <class... Ts, class... As>
+Task<std::tuple<detail::NonVoid<Ts>...>> when_all(Task<Ts, As>... tasks) {
+    std::array<detail::FanOutChild, sizeof...(Ts)> children{detail::makeChild(tasks)...};
+    co_await detail::WhenAllAwaiter<decltype(children)>(children);
+    co_return std::tuple<detail::NonVoid<Ts>...>{detail::takeResult(tasks)...};
+}
+
+// Range when_all: vector of results (or void) in input order
+template <class T, class A>
+Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> when_all(std::vector<Task<T, A>> tasks) {
+    std::vector<detail::FanOutChild> children;
+    children.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        children.push_back(detail::makeChild(task));
+    }
+    co_await detail::WhenAllAwaiter<decltype(children)>(children);
+    if constexpr (std::is_void_v<T>) {
+        for (const auto& task : tasks) {
+            task.handle().promise().take();
+        }
+    } else {
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (const auto& task : tasks) {
+            results.push_back(detail::takeResult(task));
+        }
+        co_return results;
+    }
+}
+
+// Range when_any: index and result of the first task to finish
+template <class T, class A>
+Task<std::conditional_t<std::is_void_v<T>, std::size_t, WhenAnyResult<T>>> when_any(std::vector<Task<T, A>> tasks) {
+    if (tasks.empty()) {
+        throw std::invalid_argument("when_any needs at least one task");
+    }
+    auto* state = new detail::WhenAnyState<T, A>(std::move(tasks));
+    detail::WhenAnyRef<T, A> ref{state};
+    co_await detail::WhenAnyAwaiter<T, A>{state};
+    std::size_t winner = state->winner();
+    if constexpr (std::is_void_v<T>) {
+        detail::takeResult(state->task(winner));
+        co_return winner;
+    } else {
+        co_return WhenAnyResult<T>{winner, detail::takeResult(state->task(winner))};
+    }
+}
+
+// Variadic when_any over tasks of the same result type
+template <class T, class A, class... Rest>
+auto when_any(Task<T, A> first, Task<T, Rest>... rest) {
+    static_assert((std::is_same_v<A, Rest> && ...), "when_any(tasks...) needs identical Task types");
+    std::vector<Task<T, A>> tasks;
+    tasks.reserve(1 + sizeof...(rest));
+    tasks.push_back(std::move(first));
+    (tasks.push_back(std::move(rest)), ...);
+    return when_any(std::move(tasks));
+}